@@ -12,6 +12,7 @@
 #include <assert.h>
 #include <cstddef>
 #include <string> // char_traits
+#include <string_view>
 
 #define D_INLINE constexpr
 #define D_NOEXCEPTION noexcept(true)
@@ -69,6 +70,13 @@ public:
      */
     size_t length() const D_NOEXCEPTION { return len_; };
 
+    /**
+     *  @brief access pointer and length together.
+     *  @return view of constant string.
+     *  @throw This function will not throw an exception.
+     */
+    std::basic_string_view<TChar> view() const D_NOEXCEPTION { return {data_, len_}; };
+
 private:
     const TChar* data_;
     size_t len_;
@@ -101,6 +109,10 @@ __sv_limit(size_t __size, size_t __pos, size_t __off) D_NOEXCEPTION
  *  @tparam _AMChar Type of character
  *  @tparam _AMTraits Traits for character type, defaults to
  *                   char_traits<_AMChar>.
+ *  @tparam TStringProvider Provides string by view(). Provider
+ *                   may return another string on every call, so
+ *                   every member reads it once and takes pointer
+ *                   and length from the same view.
  *
  *  A AMBasicConstString looks like this:
  *
@@ -112,6 +124,8 @@ class AMBasicConstString
     static_assert(std::is_trivial_v<_AMChar> && std::is_standard_layout_v<_AMChar>);
     static_assert(std::is_same_v<_AMChar, typename _AMTraits::char_type>);
     friend class AMLString;
+    friend class AMLStringPlural;
+    friend class AMLStringHandle;
 
 public:
 
@@ -210,7 +224,8 @@ public:
     D_INLINE
     const_iterator end() const D_NOEXCEPTION
     {
-        return this->data() + this->length();
+        const auto __sv = this->view();
+        return __sv.data() + __sv.size();
     }
 
     /**
@@ -233,7 +248,7 @@ public:
     D_INLINE
     const_iterator cend() const D_NOEXCEPTION
     {
-        return this->data() + this->length();
+        return this->end();
     }
 
     /**
@@ -298,7 +313,7 @@ public:
     D_INLINE
     size_type size() const D_NOEXCEPTION
     {
-        return _M_provider.length();
+        return this->view().size();
     }
 
     /**
@@ -335,7 +350,20 @@ public:
     D_INLINE
     const value_type* data() const D_NOEXCEPTION
     {
-        return _M_provider.c_str();
+        return this->view().data();
+    }
+
+    /**
+     *  @brief Returns pointer and length taken from one call of
+     *         provider. Use it instead of data() and size() pair.
+     *  @return string_view of the string.
+     *  @throw This function will not throw an exception.
+     */
+    D_INLINE
+    std::basic_string_view<_AMChar, _AMTraits> view() const D_NOEXCEPTION
+    {
+        const auto __v = _M_provider.view();
+        return std::basic_string_view<_AMChar, _AMTraits>(__v.data(), __v.size());
     }
 
     /**
@@ -357,8 +385,9 @@ public:
     D_INLINE
     const_reference operator [](size_type __pos) const D_NOEXCEPTION
     {
-        assert(__pos < this->size());
-        return *(this->data() + __pos);
+        const auto __sv = this->view();
+        assert(__pos < __sv.size());
+        return *(__sv.data() + __pos);
     }
 
     /**
@@ -370,11 +399,12 @@ public:
     D_INLINE
     const_reference at(size_type __pos) const
     {
-        if (__pos >= length())
+        const auto __sv = this->view();
+        if (__pos >= __sv.size())
             std::__throw_out_of_range_fmt(__N("AMBasicConstString::at: __pos "
                                               "(which is %zu) >= this->size() "
-                                              "(which is %zu)"), __pos, this->size());
-            return *(this->data() + __pos);
+                                              "(which is %zu)"), __pos, __sv.size());
+            return *(__sv.data() + __pos);
     }
 
     /**
@@ -386,8 +416,9 @@ public:
     D_INLINE
     const_reference front() const D_NOEXCEPTION
     {
-        assert(this->size() > 0);
-        return *this->data();
+        const auto __sv = this->view();
+        assert(__sv.size() > 0);
+        return *__sv.data();
     }
 
     /**
@@ -399,8 +430,9 @@ public:
     D_INLINE
     const_reference back() const D_NOEXCEPTION
     {
-        assert(this->size() > 0);
-        return *(this->data() + this->size() - 1);
+        const auto __sv = this->view();
+        assert(__sv.size() > 0);
+        return *(__sv.data() + __sv.size() - 1);
     }
 
     /**
@@ -429,10 +461,11 @@ public:
     size_type copy(_AMChar* __str, size_type __n, size_type __pos = 0) const
     {
         __glibcxx_requires_string_len(__str, __n);
-        __pos = std::__sv_check(size(), __pos, "AMBasicConstString::copy");
-        const size_type __rlen = std::min(__n, length() - __pos);
+        const auto __sv = this->view();
+        __pos = std::__sv_check(__sv.size(), __pos, "AMBasicConstString::copy");
+        const size_type __rlen = std::min(__n, __sv.size() - __pos);
 
-        traits_type::copy(__str, data() + __pos, __rlen);
+        traits_type::copy(__str, __sv.data() + __pos, __rlen);
 
         return __rlen;
     }
@@ -448,11 +481,7 @@ public:
     D_INLINE
     int compare(AMBasicConstString __str) const D_NOEXCEPTION
     {
-        const size_type __rlen = std::min(this->length(), __str.length());
-        int __ret = traits_type::compare(this->data(), __str.data(), __rlen);
-        if (__ret == 0)
-            __ret = _S_compare(this->length(), __str.length());
-        return __ret;
+        return this->compare(__str.view());
     }
 
     /**
@@ -466,10 +495,11 @@ public:
     D_INLINE
     int compare(std::basic_string_view<_AMChar, _AMTraits> __str) const D_NOEXCEPTION
     {
-        const size_type __rlen = std::min(this->length(), __str.length());
-        int __ret = traits_type::compare(this->data(), __str.data(), __rlen);
+        const auto __sv = this->view();
+        const size_type __rlen = std::min(__sv.length(), __str.length());
+        int __ret = traits_type::compare(__sv.data(), __str.data(), __rlen);
         if (__ret == 0)
-            __ret = _S_compare(this->length(), __str.length());
+            __ret = _S_compare(__sv.length(), __str.length());
         return __ret;
     }
 
@@ -487,8 +517,8 @@ public:
     D_INLINE
     int compare(size_type __pos1, size_type __n1, AMBasicConstString __str) const
     {
-        std::basic_string_view<_AMChar, _AMTraits> tstr(this->data(), this->length());
-        return tstr.substr(__pos1, __n1).compare(__str.data());
+        std::basic_string_view<_AMChar, _AMTraits> tstr(this->view());
+        return tstr.substr(__pos1, __n1).compare(__str.view());
     }
 
     /**
@@ -510,8 +540,8 @@ public:
     int compare(size_type __pos1, size_type __n1,
                 AMBasicConstString __str, size_type __pos2, size_type __n2) const
     {
-        std::basic_string_view<_AMChar, _AMTraits> tstr(this->data(), this->length());
-        std::basic_string_view<_AMChar, _AMTraits> ostr(__str.data(), __str.length());
+        std::basic_string_view<_AMChar, _AMTraits> tstr(this->view());
+        std::basic_string_view<_AMChar, _AMTraits> ostr(__str.view());
         return tstr.substr(__pos1, __n1).compare(ostr.substr(__pos2, __n2));
     }
 
@@ -543,7 +573,7 @@ public:
     __attribute__((__nonnull__)) D_INLINE
     int compare(size_type __pos1, size_type __n1, const _AMChar* __str) const
     {
-        std::basic_string_view<_AMChar, _AMTraits> tstr(this->data(), this->length());
+        std::basic_string_view<_AMChar, _AMTraits> tstr(this->view());
         return tstr.substr(__pos1, __n1).compare(__str);
     }
 
@@ -564,7 +594,7 @@ public:
     int compare(size_type __pos1, size_type __n1,
                 const _AMChar* __str, size_type __n2) const D_NOEXCEPTION
     {
-        std::basic_string_view<_AMChar, _AMTraits> tstr(this->data(), this->length());
+        std::basic_string_view<_AMChar, _AMTraits> tstr(this->view());
         std::basic_string_view<_AMChar, _AMTraits> ostr(__str, __n2);
         return tstr.substr(__pos1, __n1).compare(ostr);
     }
@@ -581,7 +611,8 @@ public:
     D_INLINE
     size_type find(AMBasicConstString __str, size_type __pos = 0) const D_NOEXCEPTION
     {
-        return this->find(__str.data(), __pos, __str.size());
+        const auto __sv = __str.view();
+        return this->find(__sv.data(), __pos, __sv.size());
     }
 
     /**
@@ -596,13 +627,14 @@ public:
     D_INLINE
     size_type find(_AMChar __c, size_type __pos = 0) const D_NOEXCEPTION
     {
+        const auto __sv = this->view();
         size_type __ret = npos;
-        if (__pos < this->length())
+        if (__pos < __sv.size())
         {
-            const size_type __n = this->length() - __pos;
-            const _AMChar* __p = traits_type::find(this->data() + __pos, __n, __c);
+            const size_type __n = __sv.size() - __pos;
+            const _AMChar* __p = traits_type::find(__sv.data() + __pos, __n, __c);
             if (__p)
-                __ret = __p - this->data();
+                __ret = __p - __sv.data();
         }
         return __ret;
     }
@@ -647,7 +679,8 @@ public:
     D_INLINE
     size_type rfind(AMBasicConstString __str, size_type __pos = npos) const D_NOEXCEPTION
     {
-        return this->rfind(__str.data(), __pos, __str.size());
+        const auto __sv = __str.view();
+        return this->rfind(__sv.data(), __pos, __sv.size());
     }
 
     /**
@@ -662,13 +695,14 @@ public:
     D_INLINE
     size_type rfind(_AMChar __c, size_type __pos = npos) const D_NOEXCEPTION
     {
-        size_type __size = this->length();
+        const auto __sv = this->view();
+        size_type __size = __sv.size();
         if (__size > 0)
         {
             if (--__size > __pos)
                 __size = __pos;
             for (++__size; __size-- > 0; )
-                if (traits_type::eq(this->data()[__size], __c))
+                if (traits_type::eq(__sv.data()[__size], __c))
                     return __size;
         }
         return npos;
@@ -715,7 +749,8 @@ public:
     D_INLINE
     size_type find_first_of(AMBasicConstString __str, size_type __pos = 0) const D_NOEXCEPTION
     {
-        return this->find_first_of(__str.data(), __pos, __str.size());
+        const auto __sv = __str.view();
+        return this->find_first_of(__sv.data(), __pos, __sv.size());
     }
 
     /**
@@ -776,7 +811,8 @@ public:
     D_INLINE
     size_type find_last_of(AMBasicConstString __str, size_type __pos = npos) const D_NOEXCEPTION
     {
-        return this->find_last_of(__str.data(), __pos, __str.size());
+        const auto __sv = __str.view();
+        return this->find_last_of(__sv.data(), __pos, __sv.size());
     }
 
     /**
@@ -837,7 +873,8 @@ public:
     D_INLINE
     size_type find_first_not_of(AMBasicConstString __str, size_type __pos = 0) const D_NOEXCEPTION
     {
-        return this->find_first_not_of(__str.data(), __pos, __str.size());
+        const auto __sv = __str.view();
+        return this->find_first_not_of(__sv.data(), __pos, __sv.size());
     }
 
     /**
@@ -853,8 +890,9 @@ public:
     D_INLINE
     size_type find_first_not_of(_AMChar __c, size_type __pos = 0) const D_NOEXCEPTION
     {
-        for (; __pos < this->length(); ++__pos)
-            if (!traits_type::eq(this->data()[__pos], __c))
+        const auto __sv = this->view();
+        for (; __pos < __sv.size(); ++__pos)
+            if (!traits_type::eq(__sv.data()[__pos], __c))
                 return __pos;
         return npos;
     }
@@ -902,7 +940,8 @@ public:
     D_INLINE
     size_type find_last_not_of(AMBasicConstString __str, size_type __pos = npos) const D_NOEXCEPTION
     {
-        return this->find_last_not_of(__str.data(), __pos, __str.size());
+        const auto __sv = __str.view();
+        return this->find_last_not_of(__sv.data(), __pos, __sv.size());
     }
 
     /**
@@ -918,14 +957,15 @@ public:
     D_INLINE
     size_type find_last_not_of(_AMChar __c, size_type __pos = npos) const D_NOEXCEPTION
     {
-        size_type __size = this->length();
+        const auto __sv = this->view();
+        size_type __size = __sv.size();
         if (__size)
         {
             if (--__size > __pos)
                 __size = __pos;
             do
             {
-                if (!traits_type::eq(this->data()[__size], __c))
+                if (!traits_type::eq(__sv.data()[__size], __c))
                     return __size;
             }
             while (__size--);
@@ -1024,7 +1064,7 @@ private:
     bool operator==(AMBasicConstString<_AMChar, _AMTraits, TStringProvider> __x,
                     AMBasicConstString<_AMChar, _AMTraits, TStringProvider> __y) D_NOEXCEPTION
     {
-        return __x.size() == __y.size() && __x.compare(__y) == 0;
+        return __x.view() == __y.view();
     }
 
     /**
@@ -1111,7 +1151,8 @@ private:
     operator<<(std::basic_ostream<_AMChar, _AMTraits>& __os,
                AMBasicConstString<_AMChar,_AMTraits, TStringProvider> __str)
     {
-        return __ostream_insert(__os, __str.data(), __str.size());
+        const auto __sv = __str.view();
+        return __ostream_insert(__os, __sv.data(), __sv.size());
     }
 
     inline namespace literals
@@ -1164,16 +1205,17 @@ private:
         find(const _AMChar* __str, size_type __pos, size_type __n) const D_NOEXCEPTION
     {
         __glibcxx_requires_string_len(__str, __n);
+        const auto __sv = this->view();
 
         if (__n == 0)
-            return __pos <= length() ? __pos : npos;
-        if (__pos >= length())
+            return __pos <= __sv.size() ? __pos : npos;
+        if (__pos >= __sv.size())
             return npos;
 
         const _AMChar __elem0 = __str[0];
-        const _AMChar* __first = data() + __pos;
-        const _AMChar* const __last = data() + length();
-        size_type __len = length() - __pos;
+        const _AMChar* __first = __sv.data() + __pos;
+        const _AMChar* const __last = __sv.data() + __sv.size();
+        size_type __len = __sv.size() - __pos;
 
         while (__len >= __n)
         {
@@ -1185,7 +1227,7 @@ private:
             // We already know that __first[0] == __s[0] but compare them again
             // anyway because __s is probably aligned, which helps memcmp.
             if (traits_type::compare(__first, __str, __n) == 0)
-                return __first - data();
+                return __first - __sv.data();
             __len = __last - ++__first;
         }
         return npos;
@@ -1197,13 +1239,14 @@ private:
         rfind(const _AMChar* __str, size_type __pos, size_type __n) const D_NOEXCEPTION
     {
         __glibcxx_requires_string_len(__str, __n);
+        const auto __sv = this->view();
 
-        if (__n <= this->length())
+        if (__n <= __sv.size())
         {
-            __pos = std::min(size_type(this->length() - __n), __pos);
+            __pos = std::min(size_type(__sv.size() - __n), __pos);
             do
             {
-                if (traits_type::compare(this->data() + __pos, __str, __n) == 0)
+                if (traits_type::compare(__sv.data() + __pos, __str, __n) == 0)
                     return __pos;
             }
             while (__pos-- > 0);
@@ -1217,10 +1260,11 @@ private:
         find_first_of(const _AMChar* __str, size_type __pos, size_type __n) const D_NOEXCEPTION
     {
         __glibcxx_requires_string_len(__str, __n);
+        const auto __sv = this->view();
 
-        for (; __n && __pos < this->length(); ++__pos)
+        for (; __n && __pos < __sv.size(); ++__pos)
         {
-            const _AMChar* __p = traits_type::find(__str, __n, this->data()[__pos]);
+            const _AMChar* __p = traits_type::find(__str, __n, __sv.data()[__pos]);
             if (__p)
                 return __pos;
         }
@@ -1233,14 +1277,15 @@ private:
         find_last_of(const _AMChar* __str, size_type __pos, size_type __n) const D_NOEXCEPTION
     {
         __glibcxx_requires_string_len(__str, __n);
-        size_type __size = this->size();
+        const auto __sv = this->view();
+        size_type __size = __sv.size();
         if (__size && __n)
         {
             if (--__size > __pos)
                 __size = __pos;
             do
             {
-                if (traits_type::find(__str, __n, this->data()[__size]))
+                if (traits_type::find(__str, __n, __sv.data()[__size]))
                     return __size;
             }
             while (__size-- != 0);
@@ -1254,8 +1299,9 @@ private:
         find_first_not_of(const _AMChar* __str, size_type __pos, size_type __n) const D_NOEXCEPTION
     {
         __glibcxx_requires_string_len(__str, __n);
-        for (; __pos < this->length(); ++__pos)
-            if (!traits_type::find(__str, __n, this->data()[__pos]))
+        const auto __sv = this->view();
+        for (; __pos < __sv.size(); ++__pos)
+            if (!traits_type::find(__str, __n, __sv.data()[__pos]))
                 return __pos;
         return npos;
     }
@@ -1266,14 +1312,15 @@ private:
         find_last_not_of(const _AMChar* __str, size_type __pos, size_type __n) const D_NOEXCEPTION
     {
         __glibcxx_requires_string_len(__str, __n);
-        size_type __size = this->length();
+        const auto __sv = this->view();
+        size_type __size = __sv.size();
         if (__size)
         {
             if (--__size > __pos)
                 __size = __pos;
             do
             {
-                if (!traits_type::find(__str, __n, this->data()[__size]))
+                if (!traits_type::find(__str, __n, __sv.data()[__size]))
                     return __size;
             }
             while (__size--);
@@ -7,10 +7,53 @@
 #ifndef AMLSTRING_H
 #define AMLSTRING_H
 
+#include <atomic>
+#include <initializer_list>
+#include <string>
+#include <string_view>
 #include <utility>
+#include <vector>
 #include "AMBasicCString.h"
+#include "AMLStringArena.h"
+#include "AMLStringPerfectHash.h"
+#include "AMLStringPlural.h"
 #include "amfnv1a/AMCEFNV1a.h"
 
+#ifdef AMLSTRING_FIXED_LANGUAGE
+namespace AMCore {
+    /*
+     *  Translation in catalog header generated by "AMLStringPoCompiler --fixed"
+     */
+    struct _T_AM_StringFixedEntry
+    {
+        uint64_t    _M_hash;
+        const char* _M_original;
+        const char* _M_translation;
+        uint32_t    _M_length;          // all plural forms
+    };
+}
+#include AMLSTRING_FIXED_LANGUAGE
+namespace AMCore {
+    inline constexpr AMLStringPluralRule _T_AM_StringFixedPluralRule = []() constexpr {
+        AMLStringPluralRule rule;
+        rule.parseHeader(_T_AM_StringFixedHeader);
+        return rule;
+    }();
+}
+// translations are constant, resolution is evaluated at compile time
+#define AMLSTRING_VIEW_INLINE constexpr
+#else
+#define AMLSTRING_VIEW_INLINE inline
+#endif
+
+// initial-exec thread local is a single load relative to thread pointer, but shared library using it
+// may fail to load by dlopen(), so the model is taken only when AMLString is linked statically
+#ifdef AMLSTRING_STATIC
+#define AMLSTRING_TLS_MODEL __attribute__((tls_model("initial-exec")))
+#else
+#define AMLSTRING_TLS_MODEL
+#endif
+
 /**
  *  @ingroup Strings
  *  @{
@@ -18,30 +61,374 @@
 
 namespace AMCore {
 
+    class AMLString;
     class _T_AM_StringItemBase;
+    struct _T_AM_StringItemSlot;
+    class AMLStringCatalog;
+    class AMLStringCompiledCatalog;
+    struct _T_AM_StringView;
+    class AMLStringLanguage;
+
+#ifndef AMLSTRING_MAX_LANGUAGES
+#define AMLSTRING_MAX_LANGUAGES 32
+#endif
+
+    /**
+     *  @ingroup Strings
+     *  @brief Small index of language slot, lower than AMLSTRING_MAX_LANGUAGES
+     */
+    using AMLStringLanguageId = uint8_t;
+
+    /**
+     *  @ingroup Strings
+     *  @brief Result of binding string table to message catalog
+     */
+    struct AMLStringBindReport
+    {
+        size_t matched;     ///< items translated by catalog
+        size_t missing;     ///< items without translation in catalog
+        size_t orphaned;    ///< catalog entries without item
+    };
+
+    /**
+     *  @ingroup Strings
+     *  @brief Result of binding string table to chain of catalogs (e.g. cs_CZ, cs)
+     */
+    struct AMLStringFallbackReport
+    {
+        size_t              matched;    ///< items translated by any layer
+        size_t              missing;    ///< items left with original string
+        std::vector<size_t> supplied;   ///< number of items translated by each layer
+        std::vector<int>    layers;     ///< layer which translated each item in table order, -1 for original
+    };
+
+    class _T_AM_StringList;
+    struct _T_AM_StringDirectory;
+    struct _T_AM_StringLookup;
+    struct _T_AM_StringOrder;
+
+    /**
+     *  @ingroup Strings
+     *  @brief Name hash of string table, <code>_T_AM_StringList::GetStringTable<"errors"_hash>()</code>
+     *         resolves the table at compile time.
+     */
+    constexpr uint64_t operator""_hash(const char* name, size_t)
+    {
+        return AMCEFNV1aAlgorithm::fnv1a64(name);
+    }
+
+    /*
+     *  Tables merged by _T_AM_StringList::Add(), stored contiguously in table directory
+     */
+    struct _T_AM_StringListRange
+    {
+        _T_AM_StringList* const* _M_begin;
+        _T_AM_StringList* const* _M_end;
+
+        _T_AM_StringList* const* begin() const noexcept {return _M_begin;}
+        _T_AM_StringList* const* end() const noexcept {return _M_end;}
+        size_t size() const noexcept {return _M_end - _M_begin;}
+    };
+
+    /*
+     *  Items of one table sorted by original string, see _T_AM_StringList::items()
+     */
+    struct _T_AM_StringItemRange
+    {
+        _T_AM_StringItemBase* const* _M_begin;
+        _T_AM_StringItemBase* const* _M_end;
+
+        _T_AM_StringItemBase* const* begin() const noexcept {return _M_begin;}
+        _T_AM_StringItemBase* const* end() const noexcept {return _M_end;}
+        size_t size() const noexcept {return _M_end - _M_begin;}
+    };
+
+    /*
+     *  Translation of one item in table of all ordinals, pointer and length of the pair fill 16 bytes
+     *  with sequence odd while writer changes them. Readers retry the rare read overlapping a write,
+     *  writers are serialized by caller.
+     */
+    struct _T_AM_StringTranslation
+    {
+        std::atomic<const char*> _M_str;
+        std::atomic<uint32_t>    _M_length;
+        std::atomic<uint32_t>    _M_sequence;
+
+        std::string_view view() const noexcept
+        {
+            for (;;) {
+                const uint32_t sequence = _M_sequence.load(std::memory_order_acquire);
+                const char* str = _M_str.load(std::memory_order_relaxed);
+                const uint32_t length = _M_length.load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (!(sequence & 1) && _M_sequence.load(std::memory_order_relaxed) == sequence)
+                    return std::string_view(str, length);
+            }
+        }
+
+        void store(const char* str, uint32_t length) noexcept
+        {
+            const uint32_t sequence = _M_sequence.load(std::memory_order_relaxed);
+            _M_sequence.store(sequence + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            _M_str.store(str, std::memory_order_relaxed);
+            _M_length.store(length, std::memory_order_relaxed);
+            _M_sequence.store(sequence + 2, std::memory_order_release);
+        }
+    };
+
+    /*
+     *  Item record placed into "amlstring_items" linker section (AMLSTRING_SECTION_REGISTRATION mode).
+     *  Alignment keeps the entries of all object files packed as one array.
+     */
+    struct alignas(16) _T_AM_StringSectionEntry
+    {
+        _T_AM_StringList*     _M_list;
+        _T_AM_StringItemBase* _M_item;
+    };
+
+    /*
+     *  Section bounds of one module, linked to list of sections waiting for scan
+     */
+    struct _T_AM_StringSectionRange
+    {
+        const _T_AM_StringSectionEntry* _M_begin;
+        const _T_AM_StringSectionEntry* _M_end;
+        _T_AM_StringSectionRange*       _M_next;
+    };
 
     class _T_AM_StringList
     {
         _T_AM_StringList*         _M_next;
         static _T_AM_StringList*  _M_root;
+        static std::atomic<_T_AM_StringSectionRange*> _M_pending_sections;
+        static uint32_t           _M_item_count;
+        static std::atomic<_T_AM_StringItemSlot* const*> _M_slot_index;
+        static std::atomic<_T_AM_StringTranslation*> _M_translation_index;
+        static std::atomic<uint32_t> _M_slot_index_count;
         const uint64_t            _M_name_hash;
         _T_AM_StringList*         _M_next_chunk;
+        std::atomic<AMLStringLanguage*> _M_binding;        // language of bind() and Load(), nullptr if unbound
+        _T_AM_StringItemBase*     _M_last_item;
+        std::atomic<bool>         _M_unsorted;
+        std::atomic<const _T_AM_StringOrder*> _M_order;    // nullptr until finalize()
+        const _T_AM_StringOrder*  _M_orders;                // all built, walkers may still use old ones
+        std::atomic<const _T_AM_StringLookup*> _M_lookup;  // nullptr until find() after finalize()
+        const _T_AM_StringLookup* _M_lookups;               // all built, readers may still use old ones
 /*
          virtual bool SaveContent(void* vpnode)=0;
          virtual int  LoadContent(void* vpdoc, void* vpnode)=0;*/
+        void appendItem(_T_AM_StringItemBase* item);
+        static void scanSections();
+        void sortItems();
+        static void indexSlots();
+        static void storeTranslation(uint32_t ordinal, const _T_AM_StringView* translation) noexcept;
+        void publishBinding(AMLStringLanguage* binding);
+        const _T_AM_StringLookup* buildLookup();
+        const _T_AM_StringLookup* lookup();
+        static const _T_AM_StringDirectory* directory();
+        AMLStringBindReport bindItems(const AMLStringCatalog& catalog, _T_AM_StringView* views, uint32_t viewBase,
+                                      uint32_t viewCount, unsigned threads = 1);
+        AMLStringBindReport bindItems(const AMLStringCompiledCatalog& catalog, _T_AM_StringView* views,
+                                      uint32_t viewBase, uint32_t viewCount);
+        AMLStringFallbackReport bindItems(const AMLStringCatalog* const* catalogs, size_t count,
+                                          _T_AM_StringView* views, uint32_t viewBase, uint32_t viewCount);
+        AMLStringFallbackReport bindItems(const AMLStringCompiledCatalog* const* catalogs, size_t count,
+                                          _T_AM_StringView* views, uint32_t viewBase, uint32_t viewCount);
+        friend class AMLStringLanguage;
+        friend class AMLStringLoader;
+        friend class AMLStringWatcher;
+        friend struct _T_AM_StringItemSlot;
     public:
         _T_AM_StringItemBase* _M_first_item;
     //    int                       _M_length;
     public:
         _T_AM_StringList(const uint64_t tableHash);
         ~_T_AM_StringList();
+
+        /**
+         * @brief Finds table in directory sorted by name hash. Directory is rebuilt only after new table
+         *        is created or tables are merged.
+         * @param nameHash FNV1a hash of table name
+         * @return finalized table or nullptr
+         */
         static _T_AM_StringList* GetStringTable(const uint64_t nameHash);
+
+        /**
+         * @param name table name
+         * @return finalized table or nullptr
+         */
         static _T_AM_StringList* GetStringTable(const char* name);
+
+        /**
+         * @brief Resolves table at compile time, no lookup is done. Table is created if no string
+         *        uses it.
+         * @tparam nameHash FNV1a hash of table name, e.g. "default"_hash
+         * @return finalized table
+         */
+        template<uint64_t nameHash>
+        static _T_AM_StringList* GetStringTable();
+
+        /**
+         * @return this table followed by tables merged with it by Add()
+         */
+        _T_AM_StringListRange chunks() const;
+
+        /**
+         * @brief Finds string by original known only at runtime, e.g. message key read from database.
+         *        Items of table are indexed by perfect hash on first call after table was finalized,
+         *        Bloom filter rejects most strings not in table without reading any item. Lookup takes
+         *        no lock, index is immutable and replaced as a whole.
+         * @param original original string, "context\x04string" for string with context
+         * @return item or nullptr if table has no such string
+         */
+        const _T_AM_StringItemBase* find(std::string_view original);
+
+        /**
+         * @param original original string, "context\x04string" for string with context
+         * @param fallback string returned if table has no such string
+         * @return registered string with original or fallback
+         */
+        AMLString find(std::string_view original, const AMLString& fallback);
+
+        /**
+         * @brief Finds all items translated by one catalog entry: singular string and plural strings
+         *        of the same msgid, as bind() matches them.
+         * @param msgid original of catalog entry, "singular\0plural" for plural entry
+         * @return items, empty if table has no such string
+         */
+        std::vector<const _T_AM_StringItemBase*> findAll(std::string_view msgid);
+
+        /**
+         * @brief Finalizes table and returns its items sorted by original string. Order is immutable
+         *        snapshot, it may be walked while other threads register strings and finalize the
+         *        table. Links of getNextItem() are rewritten by finalize(), walk them only when no
+         *        other thread registers.
+         * @return items registered before the last finalize()
+         */
+        _T_AM_StringItemRange items();
+
+        /**
+         * @brief Appends item and gives it the next ordinal. Process aborts when all tables together
+         *        would hold more than UNREGISTERED items.
+         */
         _T_AM_StringList& registerItem(_T_AM_StringItemBase* item);
         void Add(_T_AM_StringList& second);
+
+        /**
+         * @brief Sorts items registered since last call by original string. Registration only appends,
+         *        table is finalized by GetStringTable() and bind() automatically. Sorted order is
+         *        published as new snapshot of items(), threads walking the previous one keep it.
+         */
+        void finalize();
+
+        /**
+         * @brief Finalizes all tables and indexes slots and translations of all items by ordinal.
+         * @return number of registered items, ordinals of items are lower than this number
+         */
+        static uint32_t finalizeAll();
+
+        /**
+         * @return number of items indexed by finalizeAll()
+         */
+        static uint32_t indexedCount() noexcept
+        {
+            return _M_slot_index_count.load(std::memory_order_acquire);
+        }
+
+        /**
+         * @param ordinal ordinal lower than indexedCount()
+         * @return slot of registered item
+         */
+        static const _T_AM_StringItemSlot* slot(uint32_t ordinal) noexcept
+        {
+            return _M_slot_index.load(std::memory_order_acquire)[ordinal];
+        }
+
+        /**
+         * @brief Translations of items are one array indexed by ordinal like views of languages, string
+         *        no language translates is resolved by the entry alone.
+         * @param ordinal ordinal lower than indexedCount()
+         * @return translation set by bind(), Load() or setTranslatedString(), item string otherwise
+         */
+        static const _T_AM_StringTranslation& translation(uint32_t ordinal) noexcept
+        {
+            return _M_translation_index.load(std::memory_order_acquire)[ordinal];
+        }
+
+        /**
+         * @brief Adds linker section of one module. Items are registered from it lazily by finalize(),
+         *        items registered already are skipped.
+         * @param range section bounds, must live forever
+         */
+        static void registerSection(_T_AM_StringSectionRange* range);
+
+        /**
+         * @brief Maps <b>.mo</b> file and points translations of all items into it.
+         *        Previously bound catalog is retired, it is unmapped by AMLStringLanguage::reclaim().
+         * @param name file name
+         * @return number of translated items or -1 if file cannot be loaded
+         */
+        int  Load(const char* name);
+
+        /**
+         * @brief Restores original strings and plural rule of all items. Catalog loaded by Load()
+         *        is retired, it is unmapped by AMLStringLanguage::reclaim().
+         */
+        void Unload();
+
+        /**
+         * @brief Points translations of all items into catalog. Every msgid of catalog is looked up by
+         *        perfect hash of registered originals. Items not found in catalog get original strings.
+         *        Plural rule is taken from catalog header. Translations are bound into new language
+         *        (see binding()) and every slot is switched to it by one atomic store, readers never
+         *        see pointer of one translation with length of another. Replaced binding is retired.
+         * @param catalog opened catalog, must live as long as it is bound
+         * @return counts of matched, missing and orphaned entries
+         */
+        AMLStringBindReport bind(const AMLStringCatalog& catalog);
+
+        /**
+         * @brief Points translations of all items into catalog compiled into program. Items are found
+         *        by hash, no string is copied.
+         * @param catalog compiled catalog
+         * @return counts of matched, missing and orphaned entries
+         */
+        AMLStringBindReport bind(const AMLStringCompiledCatalog& catalog);
+
+        /**
+         * @brief Points translations of all items into chain of catalogs, e.g. cs_CZ, cs. Every item
+         *        takes translation of the first catalog having it, items not found in any catalog
+         *        get original strings. Chain is resolved here, reading a string does not walk it.
+         * @param catalogs opened catalogs, most specific first, nullptr entries are skipped
+         * @param count number of catalogs
+         * @return counts of translated and missing items and layer of every item
+         */
+        AMLStringFallbackReport bind(const AMLStringCatalog* const* catalogs, size_t count);
+
+        /**
+         * @brief Points translations of all items into chain of compiled catalogs.
+         * @param catalogs compiled catalogs, most specific first, nullptr entries are skipped
+         * @param count number of catalogs
+         * @return counts of translated and missing items and layer of every item
+         */
+        AMLStringFallbackReport bind(const AMLStringCompiledCatalog* const* catalogs, size_t count);
+
+        /**
+         * @return language holding translations of the last bind() or Load(), nullptr if table
+         *         is not bound
+         */
+        const AMLStringLanguage* binding() const noexcept
+        {
+            return _M_binding.load(std::memory_order_acquire);
+        }
+
+        /**
+         * @return plural rule of bound catalog, "n != 1" if table is not bound
+         */
+        const AMLStringPluralRule& pluralRule() const noexcept;
         /*
            bool Save(const char* name);
-           int  Load(const char* name);
         */
     };
 
@@ -51,6 +438,7 @@ namespace AMCore {
         static _T_AM_StringList _M_list;
     public:
         _T_AM_StringList& list() {return _M_list;}
+        static constexpr _T_AM_StringList* table() {return &_M_list;}
         static _T_AM_StringList& registerItem(_T_AM_StringItemBase* item)
         {
             return _M_list.registerItem(item);
@@ -59,23 +447,34 @@ namespace AMCore {
     template<uint64_t tableHash>
     _T_AM_StringList _T_AM_StringListHolder<tableHash>::_M_list(tableHash);
 
+    template<uint64_t nameHash>
+    _T_AM_StringList* _T_AM_StringList::GetStringTable()
+    {
+        _T_AM_StringList* list = _T_AM_StringListHolder<nameHash>::table();
+        list->finalize();
+        return list;
+    }
+
     class _T_AM_String;
 
     class AMLStringProvider
     {
-        const _T_AM_StringItemBase* _M_string_item;
+        const _T_AM_StringItemSlot* _M_slot;
 
         constexpr
-        AMLStringProvider(const _T_AM_StringItemBase* stringItem) :
-            _M_string_item(stringItem)
+        AMLStringProvider(const _T_AM_StringItemSlot* slot) :
+            _M_slot(slot)
         {}
 
         friend class AMLString;
+        friend class AMLStringHandle;
         friend class _T_AM_String;
         friend class _T_AM_StringItemBase;
     public:
-        constexpr const char* c_str() const noexcept;
-        constexpr size_t length() const noexcept;
+        /**
+         * @return translated string, pointer and length from one language
+         */
+        AMLSTRING_VIEW_INLINE std::string_view view() const noexcept;
     };
 
     using AMLStringBase = AMBasicConstString<char, std::char_traits<char>, AMLStringProvider>;
@@ -92,8 +491,14 @@ namespace AMCore {
         constexpr
         AMLString(const AMLStringProvider& provider) noexcept:
             AMLStringBase(provider) {}
+
+        constexpr
+        const _T_AM_StringItemBase* item() const noexcept;
         friend class _T_AM_String;
         friend class _T_AM_StringItemBase;
+        friend class AMLStringLanguage;
+        friend class AMLStringOverlay;
+        friend class AMLStringHandle;
     public:
 
         /**
@@ -113,115 +518,1357 @@ namespace AMCore {
          */
         constexpr
         std::string_view getOriginalStringView() const noexcept;
+
+        /**
+         * @return context given to _C function, empty for other strings
+         */
+        constexpr
+        std::string_view getContext() const noexcept;
+
+        /**
+         * @brief Stable identifier of string, equal to AMCEFNV1aAlgorithm::fnv1a64() of original string.
+         *        Compare it before comparing strings.
+         * @return FNV1a hash of original string
+         */
+        constexpr
+        uint64_t id() const noexcept;
+
+        /**
+         * @brief Pointer and length of translated string taken from one language, the only accessor
+         *        which never tears. Separate c_str() and size() agree across activate() only on
+         *        AMLStringReader threads between quiescent states and inside AMLStringLanguageScope.
+         * @return translated string (string_view)
+         */
+        AMLSTRING_VIEW_INLINE std::string_view view() const noexcept;
+
+        using AMLStringBase::c_str;
+        using AMLStringBase::size;
+
+        /**
+         * @param languageId slot of loaded language
+         * @return translated string in given language (const char*)
+         */
+        AMLSTRING_VIEW_INLINE const char* c_str(AMLStringLanguageId languageId) const noexcept;
+
+        /**
+         * @param languageId slot of loaded language
+         * @return translated string length in given language
+         */
+        AMLSTRING_VIEW_INLINE size_t size(AMLStringLanguageId languageId) const noexcept;
+
+        /**
+         * @param languageId slot of loaded language
+         * @return translated string in given language (string_view)
+         */
+        AMLSTRING_VIEW_INLINE std::string_view view(AMLStringLanguageId languageId) const noexcept;
+
+        /**
+         * @brief Resolves many strings at once, the same as view() of each. Memory of strings ahead
+         *        is prefetched, so latencies of lookups overlap.
+         * @param strings strings to resolve
+         * @param count number of strings
+         * @param views translated strings, count items
+         */
+        static void resolve(const AMLString* strings, size_t count, std::string_view* views) noexcept;
     };
 
-    struct _T_AM_StringItemBase
+    class AMLStringPluralProvider
     {
-        const char* _M_str;
-        int         _M_length;
-        const char* _M_original_str;
-        int         _M_original_length;
-        _T_AM_StringItemBase* _M_next;
-    public:
-        constexpr static int ceLength(const char* src)
-        {
-            int len = 0;
-            while(src[len] != '\0') len++;
-            return len + 1;
-        }
+        const _T_AM_StringItemSlot* _M_slot;
+#ifdef AMLSTRING_FIXED_LANGUAGE
+        const AMLStringPluralRule*  _M_rule;
+#else
+        const _T_AM_StringList*     _M_table;       // its binding translates item if language does not
+#endif
+        unsigned long               _M_count;
 
+#ifdef AMLSTRING_FIXED_LANGUAGE
         constexpr
-        _T_AM_StringItemBase(const char* str) :
-            _M_str(str),
-            _M_length(_T_AM_StringItemBase::ceLength(str)),
-            _M_original_length(_M_length),
-            _M_original_str(str),
-            _M_next(nullptr)
+        AMLStringPluralProvider(const _T_AM_StringItemSlot* slot, const AMLStringPluralRule* rule,
+                                unsigned long count) :
+            _M_slot(slot),
+            _M_rule(rule),
+            _M_count(count)
         {}
-
+#else
         constexpr
-        _T_AM_StringItemBase() :
-            _M_str(nullptr),
-            _M_length(0),
-            _M_original_str(nullptr),
-            _M_original_length(0),
-            _M_next(nullptr)
+        AMLStringPluralProvider(const _T_AM_StringItemSlot* slot, const _T_AM_StringList* table,
+                                unsigned long count) :
+            _M_slot(slot),
+            _M_table(table),
+            _M_count(count)
         {}
+#endif
 
-        constexpr
-        const char* getTranslatedString() const noexcept
-        {
-            return _M_str;
-        }
+        friend class AMLStringPlural;
+        friend class _T_AM_String;
+    public:
+        /**
+         * @return translated form, pointer and length from one language
+         */
+        AMLSTRING_VIEW_INLINE std::string_view view() const noexcept;
+    };
 
-        constexpr
-        void setTranslatedString(const char* str) noexcept
-        {
-            _M_str = str;
-            _M_length = _T_AM_StringItemBase::ceLength(str);
-        }
+    using AMLStringPluralBase = AMBasicConstString<char, std::char_traits<char>, AMLStringPluralProvider>;
 
+    /**
+     *  @ingroup Strings
+     *  @brief Object returned by "_N" function, form of translated string selected by count
+     *
+     *  Item holds all plural forms, form is selected by plural rule of the language (or of the catalog
+     *  bound to string table) when string is read.
+     */
+    class AMLStringPlural: public AMLStringPluralBase
+    {
         constexpr
-        const char* getOriginalString() const noexcept
-        {
-            return _M_original_str;
-        }
+        AMLStringPlural(const AMLStringPluralProvider& provider) noexcept:
+            AMLStringPluralBase(provider) {}
+        friend class _T_AM_String;
+    public:
 
+        /**
+         * @return original singular string (const char*)
+         */
         constexpr
-        size_t getOriginalLength() const noexcept
-        {
-            return _M_original_length == 0 ? 0 : _M_original_length - 1;
-        }
+        const char* getOriginalString() const noexcept;
 
-        AMLString getAMLString() const
-        {
-            AMLStringProvider prov(this);
-            AMLString amls(prov);
-            return amls;
-        }
+        /**
+         * @return original plural string (string_view)
+         */
+        constexpr
+        std::string_view getOriginalPluralString() const noexcept;
 
+        /**
+         * @return count selecting the form
+         */
         constexpr
-        int getTranslatedLength() const noexcept
+        unsigned long count() const noexcept
         {
-            return _M_length == 0 ? 0 : _M_length - 1;
+            return _M_provider._M_count;
         }
 
+        /**
+         * @return FNV1a hash of original singular string, same as AMLString::id()
+         */
         constexpr
-        _T_AM_StringItemBase* getNextItem() const noexcept
-        {
-            return _M_next;
-        }
+        uint64_t id() const noexcept;
+
+        /**
+         * @return translated form (string_view)
+         */
+        AMLSTRING_VIEW_INLINE std::string_view view() const noexcept;
+
+        using AMLStringPluralBase::c_str;
+        using AMLStringPluralBase::size;
+
+        /**
+         * @param languageId slot of loaded language
+         * @return translated form in given language (const char*)
+         */
+        AMLSTRING_VIEW_INLINE const char* c_str(AMLStringLanguageId languageId) const noexcept;
+
+        /**
+         * @param languageId slot of loaded language
+         * @return translated form length in given language
+         */
+        AMLSTRING_VIEW_INLINE size_t size(AMLStringLanguageId languageId) const noexcept;
+
+        /**
+         * @param languageId slot of loaded language
+         * @return translated form in given language (string_view)
+         */
+        AMLSTRING_VIEW_INLINE std::string_view view(AMLStringLanguageId languageId) const noexcept;
     };
 
-    constexpr
-    const char* AMLStringProvider::c_str() const noexcept
+    /*
+     *  Translation of one item inside language
+     */
+    struct _T_AM_StringView
     {
-        return _M_string_item->getTranslatedString();
-    }
+        const char* _M_str;
+        uint32_t    _M_length;
+    };
 
-    constexpr
-    size_t AMLStringProvider::length() const noexcept
+    class AMLStringOverlay;
+
+    /*
+     *  Language and overlay selected by scopes and readers of calling thread. All of them are reached
+     *  by one thread local pointer, nullptr while thread has neither scope nor reader. Context lives
+     *  in the innermost scope or reader and links the enclosing one.
+     */
+    struct _T_AM_StringContext
     {
-        return _M_string_item->getTranslatedLength();
-    }
+        const AMLStringLanguage*    _M_language;    // nullptr for globally active language
+        const AMLStringOverlay*     _M_overlay;
+        _T_AM_StringContext*        _M_previous;
+        bool                        _M_pinned;      // language is the active one pinned by reader
+        static __thread _T_AM_StringContext* _M_current AMLSTRING_TLS_MODEL;
 
-    constexpr
+        /*
+         *  Context selecting globally active language inherits pin of enclosing reader, if any
+         */
+        _T_AM_StringContext(const AMLStringLanguage* language, const AMLStringOverlay* overlay) noexcept :
+            _M_language(language),
+            _M_overlay(overlay),
+            _M_previous(_M_current),
+            _M_pinned(false)
+        {
+            const _T_AM_StringContext* context = language ? nullptr : _M_current;
+            for (; context; context = context->_M_previous) {
+                if (context->_M_pinned) {
+                    _M_language = context->_M_language;
+                    _M_pinned = true;
+                    break;
+                }
+            }
+        }
+
+        _T_AM_StringContext(const _T_AM_StringContext&) = delete;
+        _T_AM_StringContext& operator=(const _T_AM_StringContext&) = delete;
+
+        /*
+         *  Context whose language is used instead of the globally active one, nullptr if there is none
+         */
+        static const _T_AM_StringContext* selecting() noexcept
+        {
+            const _T_AM_StringContext* context = _M_current;
+            return context && (context->_M_language || context->_M_pinned) ? context : nullptr;
+        }
+
+        static const AMLStringOverlay* overlay() noexcept
+        {
+            return _M_current ? _M_current->_M_overlay : nullptr;
+        }
+
+        /*
+         *  Sets pinned language of all contexts of calling thread
+         */
+        static void pin(const AMLStringLanguage* language) noexcept
+        {
+            for (_T_AM_StringContext* context = _M_current; context; context = context->_M_previous) {
+                if (context->_M_pinned)
+                    context->_M_language = language;
+            }
+        }
+    };
+
+    /**
+     *  @ingroup Strings
+     *  @brief Translation of all registered strings, published at once.
+     *
+     *  Translations are stored in a dense array indexed by item ordinal. Language is filled by load()
+     *  or bind() and then published by activate(). Published language must not be modified. Readers only
+     *  load the active pointer, they never lock nor write shared memory, so switching never tears
+     *  a string. Language which is no longer needed is passed to retire() and reclaim() deletes it
+     *  after every AMLStringReader passed a quiescent state.
+     *
+     *  Besides the active one, up to AMLSTRING_MAX_LANGUAGES languages can be published into slots,
+     *  AMLString::c_str(languageId) then resolves any string in any of them without lookup.
+     *
+     *  Language may cover only one domain (see _D), it then holds only ordinals of that domain.
+     */
+    class AMLStringLanguage
+    {
+        uint32_t                        _M_base;
+        uint32_t                        _M_count;
+        _T_AM_StringView*               _M_views;
+        std::vector<AMLStringCatalog*>  _M_catalogs;
+        AMLStringArena                  _M_arena;           // translations not pointing into catalogs
+        uint64_t                        _M_retired_epoch;
+        AMLStringLanguage*              _M_next_retired;
+        AMLStringPluralRule             _M_plural_rule;
+        static std::atomic<const AMLStringLanguage*> _M_active;
+        static std::atomic<const AMLStringLanguage*> _M_slots[AMLSTRING_MAX_LANGUAGES];
+        friend struct _T_AM_StringItemSlot;
+        friend class _T_AM_StringList;
+        friend class AMLStringWatcher;
+        friend class AMLStringLoader;
+        friend class AMLStringReader;
+
+        explicit AMLStringLanguage(_T_AM_StringList* domain);
+        void fillOriginals(_T_AM_StringList* list);
+        static bool published(const AMLStringLanguage* language) noexcept;
+    public:
+        /**
+         * @brief Creates language with original strings of all items of the default table. Strings of
+         *        named domains are left to their own tables, see _T_AM_StringList::Load().
+         */
+        AMLStringLanguage();
+
+        /**
+         * @brief Creates language for strings of one domain only. Strings of other domains are not
+         *        translated by it, views are allocated only for range of ordinals used by the domain.
+         *        Strings of other domains inside that range are left to their own tables.
+         * @param domain string table name
+         */
+        explicit AMLStringLanguage(const char* domain);
+        ~AMLStringLanguage();
+        AMLStringLanguage(const AMLStringLanguage&) = delete;
+        AMLStringLanguage& operator=(const AMLStringLanguage&) = delete;
+
+        /**
+         * @brief Maps <b>.mo</b> file and binds string table to it. Catalog is owned by language.
+         * @param name file name
+         * @param table string table name
+         * @return number of translated items or -1 if file or table cannot be found
+         */
+        int load(const char* name, const char* table = "default");
+
+        /**
+         * @brief Maps chain of <b>.mo</b> files, e.g. cs_CZ.mo, cs.mo, and binds string table to it.
+         *        Strings missing in a file are taken from the next one. Files which do not exist are
+         *        skipped.
+         * @param names file names, most specific first
+         * @param table string table name
+         * @return number of translated items or -1 if no file or table can be found
+         */
+        int load(std::initializer_list<const char*> names, const char* table = "default");
+
+        /**
+         * @brief Same as load(), but binding is read from cache file written by a previous run of
+         *        the same build (ELF build-ids of program and all loaded libraries) with the same
+         *        catalog (checksum), no string is compared then. Cache which does not match is
+         *        rewritten after binding. Programs linked without build-id are bound without cache.
+         *        Checksum reads the whole catalog on every call, cache saves comparing strings, not
+         *        reading the file.
+         * @param name file name
+         * @param cacheName cache file name, its directory must be writable
+         * @param table string table name
+         * @return number of translated items or -1 if file or table cannot be found
+         */
+        int loadCached(const char* name, const char* cacheName, const char* table = "default");
+
+        /**
+         * @brief Reads <b>.mo</b> file, copies translations of string table into arena of language and
+         *        unmaps the file. Translations are contiguous and identical ones are stored once,
+         *        language then owns no catalog and is released by unmapping its arena.
+         * @param name file name
+         * @param table string table name
+         * @return number of translated items or -1 if file or table cannot be found
+         */
+        int read(const char* name, const char* table = "default");
+
+        /**
+         * @brief Sets translation of one string, e.g. fetched from a database. Translation is copied
+         *        into arena of language. Published language must not be modified.
+         * @param string string to translate
+         * @param translation translation, all forms separated by zeros for plural string
+         * @return false if language does not hold string or memory cannot be mapped
+         */
+        bool set(const AMLString& string, std::string_view translation);
+
+        /**
+         * @return storage of translations copied by read() and set()
+         */
+        AMLStringArena& arena() noexcept
+        {
+            return _M_arena;
+        }
+
+        /**
+         * @brief Binds string table to catalog compiled into program, no file is read.
+         * @param catalogName name given to amlstring_compile_catalog()
+         * @param table string table name
+         * @return number of translated items or -1 if catalog or table cannot be found
+         */
+        int loadCompiled(const char* catalogName, const char* table = "default");
+
+        /**
+         * @brief Binds string table to chain of compiled catalogs. Missing catalogs are skipped.
+         * @param catalogNames catalog names, most specific first
+         * @param table string table name
+         * @return number of translated items or -1 if no catalog or table can be found
+         */
+        int loadCompiled(std::initializer_list<const char*> catalogNames, const char* table = "default");
+
+        /**
+         * @brief Points translations of table items into catalog. See _T_AM_StringList::bind().
+         *        Plural rule of language is taken from catalog header if it has any.
+         * @param list string table
+         * @param catalog opened catalog, must live as long as language
+         * @param threads number of threads looking up ranges of catalog msgids
+         * @return counts of matched, missing and orphaned entries
+         */
+        AMLStringBindReport bind(_T_AM_StringList& list, const AMLStringCatalog& catalog, unsigned threads = 1);
+
+        /**
+         * @brief Points translations of table items into compiled catalog.
+         * @param list string table
+         * @param catalog compiled catalog
+         * @return counts of matched, missing and orphaned entries
+         */
+        AMLStringBindReport bind(_T_AM_StringList& list, const AMLStringCompiledCatalog& catalog);
+
+        /**
+         * @brief Points translations of table items into chain of catalogs.
+         *        See _T_AM_StringList::bind(const AMLStringCatalog* const*, size_t).
+         * @param list string table
+         * @param catalogs opened catalogs, most specific first, must live as long as language
+         * @param count number of catalogs
+         * @return counts of translated and missing items and layer of every item
+         */
+        AMLStringFallbackReport bind(_T_AM_StringList& list, const AMLStringCatalog* const* catalogs, size_t count);
+
+        /**
+         * @brief Points translations of table items into chain of compiled catalogs.
+         * @param list string table
+         * @param catalogs compiled catalogs, most specific first
+         * @param count number of catalogs
+         * @return counts of translated and missing items and layer of every item
+         */
+        AMLStringFallbackReport bind(_T_AM_StringList& list, const AMLStringCompiledCatalog* const* catalogs,
+                                     size_t count);
+
+        /**
+         * @return plural rule of bound catalogs, "n != 1" if none has it
+         */
+        const AMLStringPluralRule& pluralRule() const noexcept
+        {
+            return _M_plural_rule;
+        }
+
+        /**
+         * @param ordinal item ordinal
+         * @return translation of item or nullptr if language does not hold it
+         */
+        const _T_AM_StringView* find(uint32_t ordinal) const noexcept
+        {
+            // ordinals below base wrap around above count, items of other domains have no string
+            const uint32_t index = ordinal - _M_base;
+            return index < _M_count && _M_views[index]._M_str ? &_M_views[index] : nullptr;
+        }
+
+        /**
+         * @brief Publishes language to all threads. AMLStringReader threads see it from their next
+         *        quiescent state, calling thread at once.
+         * @param language filled language, nullptr for item strings
+         * @return previously active language
+         */
+        static const AMLStringLanguage* activate(const AMLStringLanguage* language) noexcept;
+
+        /**
+         * @return language active in calling thread (see AMLStringLanguageScope) or active language
+         *         or nullptr
+         */
+        static const AMLStringLanguage* active() noexcept
+        {
+            const _T_AM_StringContext* context = _T_AM_StringContext::selecting();
+            return context ? context->_M_language : global();
+        }
+
+        /**
+         * @return language active for all threads, AMLStringReader thread sees the one of its last
+         *         quiescent state through active() (see AMLStringReader::quiescent())
+         */
+        static const AMLStringLanguage* global() noexcept
+        {
+            return _M_active.load(std::memory_order_acquire);
+        }
+
+        /**
+         * @brief Publishes language into slot, language stays available to c_str(languageId) until
+         *        slot is replaced.
+         * @param languageId slot index
+         * @param language filled language, nullptr clears the slot
+         * @return language previously published in slot
+         */
+        static const AMLStringLanguage* publish(AMLStringLanguageId languageId, const AMLStringLanguage* language) noexcept;
+
+        /**
+         * @param languageId slot index
+         * @return language published in slot or nullptr
+         */
+        static const AMLStringLanguage* language(AMLStringLanguageId languageId) noexcept
+        {
+            return _M_slots[languageId].load(std::memory_order_acquire);
+        }
+
+        /**
+         * @brief Passes language to deferred reclamation. Language is deactivated and removed from
+         *        slots.
+         * @param language language allocated by new
+         */
+        static void retire(AMLStringLanguage* language);
+
+        /**
+         * @brief Deletes retired languages which no registered reader can use anymore.
+         * @return number of deleted languages
+         */
+        static size_t reclaim();
+    };
+
+    /**
+     *  @ingroup Strings
+     *  @brief Sets language of calling thread for its lifetime, AMLString::c_str() of this thread
+     *         then resolves through it instead of the globally active language.
+     *
+     *  Scopes may be nested. Language must not be retired while any scope uses it.
+     */
+    class AMLStringLanguageScope
+    {
+        _T_AM_StringContext _M_context;
+    public:
+        /**
+         * @param language language for calling thread, nullptr for globally active language
+         */
+        explicit AMLStringLanguageScope(const AMLStringLanguage* language) noexcept :
+            _M_context(language, _T_AM_StringContext::overlay())
+        {
+            _T_AM_StringContext::_M_current = &_M_context;
+        }
+
+        /**
+         * @param languageId slot of language published by AMLStringLanguage::publish()
+         */
+        explicit AMLStringLanguageScope(AMLStringLanguageId languageId) noexcept :
+            AMLStringLanguageScope(AMLStringLanguage::language(languageId))
+        {}
+
+        ~AMLStringLanguageScope()
+        {
+            _T_AM_StringContext::_M_current = _M_context._M_previous;
+        }
+
+        AMLStringLanguageScope(const AMLStringLanguageScope&) = delete;
+        AMLStringLanguageScope& operator=(const AMLStringLanguageScope&) = delete;
+    };
+
+    /**
+     *  @ingroup Strings
+     *  @brief Small set of translations overriding a language, e.g. brand names of one tenant.
+     *
+     *  Overridden ordinals are kept in a two level sparse bitmap: one bit per block of 64 ordinals
+     *  and one 64 bit mask per block with any override. Translation is found by population count
+     *  of both levels, string which is not overridden costs a test of a single bit. Memory grows with
+     *  number of overrides, the first level takes only one bit per 64 strings.
+     *
+     *  Overlay is selected for calling thread by AMLStringOverlayScope. It must not be modified nor
+     *  destroyed while any scope uses it. Plural strings are not overridden.
+     */
+    class AMLStringOverlay
+    {
+        const AMLStringLanguage*        _M_language;
+        std::vector<uint64_t>           _M_summary;         // bit per block of 64 ordinals
+        std::vector<uint32_t>           _M_summary_rank;    // masks before summary word
+        std::vector<uint64_t>           _M_masks;           // bit per ordinal of block
+        std::vector<uint32_t>           _M_mask_rank;       // overrides before mask
+        std::vector<uint32_t>           _M_ordinals;        // sorted
+        std::vector<_T_AM_StringView>   _M_views;           // in order of ordinals
+        AMLStringArena                  _M_strings;
+        std::vector<AMLStringCatalog*>  _M_catalogs;
+        friend struct _T_AM_StringItemSlot;
+
+        void merge(std::vector<std::pair<uint32_t, _T_AM_StringView>>& overrides);
+        void buildIndex();
+    public:
+        /**
+         * @param language language under overlay, nullptr for language active in calling thread
+         */
+        explicit AMLStringOverlay(const AMLStringLanguage* language = nullptr);
+        ~AMLStringOverlay();
+        AMLStringOverlay(const AMLStringOverlay&) = delete;
+        AMLStringOverlay& operator=(const AMLStringOverlay&) = delete;
+
+        /**
+         * @brief Overrides translation of one string. String is copied, the same translation of
+         *        several strings only once. Index is rebuilt by every call, many strings are
+         *        overridden at once by set(const AMLString*, const std::string_view*, size_t).
+         * @param string string to override
+         * @param translation new translation
+         * @return false if string is not registered or memory cannot be mapped
+         */
+        bool set(const AMLString& string, std::string_view translation);
+
+        /**
+         * @brief Overrides translations of many strings, index is rebuilt once. If a string is given
+         *        more than once, its last translation is kept.
+         * @param strings strings to override
+         * @param translations new translations, count items
+         * @param count number of strings
+         * @return number of strings set, strings which are not registered or cannot be copied are
+         *         skipped
+         */
+        size_t set(const AMLString* strings, const std::string_view* translations, size_t count);
+
+        /**
+         * @brief Maps <b>.mo</b> file and overrides strings of table it translates. Catalog is owned
+         *        by overlay.
+         * @param name file name
+         * @param table string table name
+         * @return number of overridden items or -1 if file or table cannot be found
+         */
+        int load(const char* name, const char* table = "default");
+
+        /**
+         * @return number of overridden strings
+         */
+        size_t size() const noexcept
+        {
+            return _M_views.size();
+        }
+
+        /**
+         * @return language under overlay or nullptr
+         */
+        const AMLStringLanguage* language() const noexcept
+        {
+            return _M_language;
+        }
+
+        /**
+         * @param ordinal item ordinal
+         * @return overriding translation or nullptr
+         */
+        const _T_AM_StringView* find(uint32_t ordinal) const noexcept
+        {
+            const uint32_t block = ordinal >> 6;
+            if ((block >> 6) >= _M_summary.size())
+                return nullptr;
+            const uint64_t summary = _M_summary[block >> 6];
+            const uint64_t blockBit = uint64_t(1) << (block & 63);
+            if (!(summary & blockBit))
+                return nullptr;
+            const uint32_t maskIndex = _M_summary_rank[block >> 6] + __builtin_popcountll(summary & (blockBit - 1));
+            const uint64_t mask = _M_masks[maskIndex];
+            const uint64_t bit = uint64_t(1) << (ordinal & 63);
+            if (!(mask & bit))
+                return nullptr;
+            return &_M_views[_M_mask_rank[maskIndex] + __builtin_popcountll(mask & (bit - 1))];
+        }
+
+        /**
+         * @return overlay selected in calling thread or nullptr
+         */
+        static const AMLStringOverlay* active() noexcept
+        {
+            return _T_AM_StringContext::overlay();
+        }
+    };
+
+    /**
+     *  @ingroup Strings
+     *  @brief Selects overlay for calling thread for its lifetime, e.g. for one request of a tenant.
+     *
+     *  Scopes may be nested.
+     */
+    class AMLStringOverlayScope
+    {
+        _T_AM_StringContext _M_context;
+    public:
+        /**
+         * @param overlay overlay for calling thread, nullptr for no overlay
+         */
+        explicit AMLStringOverlayScope(const AMLStringOverlay* overlay) noexcept :
+            _M_context(_T_AM_StringContext::_M_current && !_T_AM_StringContext::_M_current->_M_pinned ?
+                       _T_AM_StringContext::_M_current->_M_language : nullptr, overlay)
+        {
+            _T_AM_StringContext::_M_current = &_M_context;
+        }
+
+        ~AMLStringOverlayScope()
+        {
+            _T_AM_StringContext::_M_current = _M_context._M_previous;
+        }
+
+        AMLStringOverlayScope(const AMLStringOverlayScope&) = delete;
+        AMLStringOverlayScope& operator=(const AMLStringOverlayScope&) = delete;
+    };
+
+    /**
+     *  @ingroup Strings
+     *  @brief Registers calling thread as a reader for reclamation of retired languages.
+     *
+     *  Reader calls quiescent() when it does not hold any translated string (e.g. between requests).
+     *  Reading itself costs nothing. Language activated by other thread is seen by reader from its
+     *  next quiescent state, so c_str() and size() of one string read between two quiescent states
+     *  always come from the same language. Language activated by reader thread itself is seen at once.
+     *  Pinned language is kept in the thread context like language of a scope, both are reached by one
+     *  thread local load. Readers and scopes of one thread are destroyed in reverse order.
+     */
+    class AMLStringReader
+    {
+        std::atomic<uint64_t> _M_epoch;
+        AMLStringReader*      _M_next;
+        _T_AM_StringContext   _M_context;       // language pinned at the last quiescent state
+        friend class AMLStringLanguage;
+    public:
+        AMLStringReader();
+        ~AMLStringReader();
+        AMLStringReader(const AMLStringReader&) = delete;
+        AMLStringReader& operator=(const AMLStringReader&) = delete;
+
+        /**
+         * @brief Declares that thread does not use any string obtained before.
+         */
+        void quiescent() noexcept;
+    };
+
+    typedef std::atomic<_T_AM_StringItemBase*> _T_AM_StringLink;
+
+    /*
+     *  Item is the cold part of string: original string, its hash and context. Items of static strings
+     *  are constants in read-only data, their slot and list link are static variables of the wrapper
+     *  they point to. Items created at runtime get both at registration.
+     */
+    struct _T_AM_StringItemBase
+    {
+        _T_AM_StringItemSlot* _M_slot;      // nullptr until item created at runtime is registered
+        _T_AM_StringLink*     _M_link;      // next item of table, nullptr as _M_slot
+        uint64_t    _M_hash;
+        const char* _M_original_str;
+        uint32_t    _M_original_length;
+        uint32_t    _M_context_length;      // "context\x04" prefix of original string
+    public:
+        constexpr static int ceLength(const char* src)
+        {
+            int len = 0;
+            while(src[len] != '\0') len++;
+            return len + 1;
+        }
+
+        /*
+         *  Context is separated by '\x04' as in .mo files, returns length including the separator
+         */
+        constexpr static int ceContextLength(const char* src)
+        {
+            for (int i = 0; src[i] != '\0'; ++i) {
+                if (src[i] == '\x04')
+                    return i + 1;
+            }
+            return 0;
+        }
+
+        /*
+         *  Same as AMCEFNV1aAlgorithm::fnv1a64(), iterative so that long strings do not exceed
+         *  constexpr recursion depth. Bytes may contain zeros, hash of preceding bytes is continued.
+         */
+        constexpr static uint64_t ceHash(std::string_view bytes, uint64_t hash = AMCEFNV1aAlgorithm::fnv1a64(""))
+        {
+            for (char c : bytes)
+                hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001b3ULL;
+            return hash;
+        }
+
+        constexpr static uint64_t ceHash(const char* src)
+        {
+            return ceHash(std::string_view(src));
+        }
+
+        static constexpr uint32_t UNREGISTERED = ~uint32_t(0);
+
+        constexpr
+        _T_AM_StringItemBase(const char* str) :
+            _T_AM_StringItemBase(str, _T_AM_StringItemBase::ceLength(str))
+        {}
+
+        /*
+         *  Plural item holds "singular\0plural", its length covers both strings. Item with context
+         *  holds "context\x04original", context is part of its identity but not of its string.
+         */
+        constexpr
+        _T_AM_StringItemBase(const char* str, int length, _T_AM_StringItemSlot* slot = nullptr,
+                             _T_AM_StringLink* link = nullptr) :
+            _M_slot(slot),
+            _M_link(link),
+            _M_hash(_T_AM_StringItemBase::ceHash(str)),
+            _M_original_str(str),
+            _M_original_length(static_cast<uint32_t>(length)),
+            _M_context_length(static_cast<uint32_t>(_T_AM_StringItemBase::ceContextLength(str)))
+        {}
+
+        constexpr
+        _T_AM_StringItemBase() :
+            _M_slot(nullptr),
+            _M_link(nullptr),
+            _M_hash(0),
+            _M_original_str(nullptr),
+            _M_original_length(0),
+            _M_context_length(0)
+        {}
+
+        /*
+         *  Forms are separated by '\0', index past the last form selects the last one
+         */
+        constexpr static std::string_view cePluralForm(std::string_view forms, uint32_t index)
+        {
+            for (; index; --index) {
+                const size_t end = forms.find('\0');
+                if (end == std::string_view::npos)
+                    break;
+                forms.remove_prefix(end + 1);
+            }
+            return forms.substr(0, forms.find('\0'));
+        }
+
+        /**
+         * @return translated string in active language, item must be registered
+         */
+        std::string_view getTranslatedView() const noexcept;
+
+        const char* getTranslatedString() const noexcept
+        {
+            return getTranslatedView().data();
+        }
+
+        void setTranslatedString(const char* str);
+        void setTranslatedString(const char* str, size_t length);
+        void resetTranslatedString() noexcept;
+
+        /**
+         * @return original string including context, key of catalog entry
+         */
+        constexpr
+        const char* getOriginalString() const noexcept
+        {
+            return _M_original_str;
+        }
+
+        constexpr
+        size_t getOriginalLength() const noexcept
+        {
+            return _M_original_length == 0 ? 0 : _M_original_length - 1;
+        }
+
+        /**
+         * @return original string without context, shown when there is no translation
+         */
+        constexpr
+        const char* getSourceString() const noexcept
+        {
+            return _M_original_str + _M_context_length;
+        }
+
+        constexpr
+        size_t getSourceLength() const noexcept
+        {
+            return _M_original_length == 0 ? 0 : _M_original_length - _M_context_length - 1;
+        }
+
+        /**
+         * @return context of string, empty if it has none
+         */
+        constexpr
+        std::string_view getContext() const noexcept
+        {
+            return std::string_view(_M_original_str, _M_context_length == 0 ? 0 : _M_context_length - 1);
+        }
+
+        /**
+         * @return FNV1a hash of original string, computed by compiler
+         */
+        constexpr
+        uint64_t getHash() const noexcept
+        {
+            return _M_hash;
+        }
+
+        /**
+         * @return ordinal given by registration, UNREGISTERED before
+         */
+        uint32_t getOrdinal() const noexcept;
+
+        AMLString getAMLString() const;
+
+        int getTranslatedLength() const noexcept
+        {
+            return static_cast<int>(getTranslatedView().size());
+        }
+
+        /**
+         * @return next item of the same table, nullptr for the last one. Links are rewritten by
+         *         _T_AM_StringList::finalize(), walk _T_AM_StringList::items() while other threads
+         *         register strings.
+         */
+        _T_AM_StringItemBase* getNextItem() const noexcept
+        {
+            return _M_link ? _M_link->load(std::memory_order_acquire) : nullptr;
+        }
+    };
+
+    /*
+     *  Part of item read when string is resolved: ordinal indexing views of languages and translations
+     *  of items. Slot holds nothing else, so static slots placed by the compiler and linker share cache
+     *  lines and translations are read from arrays indexed by ordinal. Slots of items created at runtime
+     *  are allocated together at registration.
+     *
+     *  Translation of item is kept in _T_AM_StringList::translation(), pointer and length of the entry
+     *  are read together.
+     */
+    struct _T_AM_StringItemSlot
+    {
+        uint32_t                    _M_ordinal;
+        const _T_AM_StringItemBase* _M_item;
+#ifdef AMLSTRING_FIXED_LANGUAGE
+        const _T_AM_StringView      _M_source;      // translation compiled in
+
+        constexpr explicit
+        _T_AM_StringItemSlot(const _T_AM_StringItemBase* item) :
+            _T_AM_StringItemSlot(item, {item->getSourceString(), static_cast<uint32_t>(item->getSourceLength())})
+        {}
+
+        constexpr
+        _T_AM_StringItemSlot(const _T_AM_StringItemBase* item, const _T_AM_StringView& translation) :
+            _M_ordinal(_T_AM_StringItemBase::UNREGISTERED),
+            _M_item(item),
+            _M_source(translation)
+        {}
+#else
+        constexpr explicit
+        _T_AM_StringItemSlot(const _T_AM_StringItemBase* item) :
+            _M_ordinal(_T_AM_StringItemBase::UNREGISTERED),
+            _M_item(item)
+        {}
+
+        /**
+         * @return translation of item itself, item string before its ordinal is indexed
+         */
+        std::string_view getItemView() const noexcept
+        {
+            const uint32_t ordinal = _M_ordinal;
+            if (ordinal < _T_AM_StringList::indexedCount())
+                return _T_AM_StringList::translation(ordinal).view();
+            return std::string_view(_M_item->getSourceString(), _M_item->getSourceLength());
+        }
+#endif
+
+        /**
+         * @return translated string in language, item string if language is nullptr
+         */
+        AMLSTRING_VIEW_INLINE
+        std::string_view getTranslatedView([[maybe_unused]] const AMLStringLanguage* language) const noexcept
+        {
+#ifndef AMLSTRING_FIXED_LANGUAGE
+            if (language) {
+                // ordinals below base wrap around above count
+                const uint32_t index = _M_ordinal - language->_M_base;
+                if (index < language->_M_count) {
+                    const _T_AM_StringView& v = language->_M_views[index];
+                    // item of another domain inside range of domain language
+                    if (v._M_str)
+                        return std::string_view(v._M_str, v._M_length);
+                }
+            }
+            return getItemView();
+#else
+            return std::string_view(_M_source._M_str, _M_source._M_length);
+#endif
+        }
+
+        /**
+         * @return translated string in active language, item string if no language is active
+         */
+        AMLSTRING_VIEW_INLINE
+        std::string_view getTranslatedView() const noexcept
+        {
+#ifdef AMLSTRING_FIXED_LANGUAGE
+            return getTranslatedView(nullptr);
+#else
+            // one thread local load, threads without scope and reader go straight to the active language
+            const _T_AM_StringContext* context = _T_AM_StringContext::_M_current;
+            if (context) {
+                if (const AMLStringOverlay* overlay = context->_M_overlay) {
+                    if (const _T_AM_StringView* v = overlay->find(_M_ordinal))
+                        return std::string_view(v->_M_str, v->_M_length);
+                    if (overlay->_M_language)
+                        return getTranslatedView(overlay->_M_language);
+                }
+                if (context->_M_language || context->_M_pinned)
+                    return getTranslatedView(context->_M_language);
+            }
+            return getTranslatedView(AMLStringLanguage::global());
+#endif
+        }
+
+#ifndef AMLSTRING_FIXED_LANGUAGE
+        /**
+         * @brief Resolves registered item by ordinal, slot is not read when language translates it.
+         * @param ordinal ordinal lower than _T_AM_StringList::indexedCount()
+         * @param language language, nullptr for item string
+         * @return translated string
+         */
+        static std::string_view getTranslatedView(uint32_t ordinal, const AMLStringLanguage* language) noexcept
+        {
+            if (language) {
+                const uint32_t index = ordinal - language->_M_base;
+                if (index < language->_M_count && language->_M_views[index]._M_str) {
+                    const _T_AM_StringView& v = language->_M_views[index];
+                    return std::string_view(v._M_str, v._M_length);
+                }
+            }
+            return _T_AM_StringList::translation(ordinal).view();
+        }
+
+        /**
+         * @param ordinal ordinal lower than _T_AM_StringList::indexedCount()
+         * @return translated string in active overlay or language
+         */
+        static std::string_view getTranslatedView(uint32_t ordinal) noexcept
+        {
+            const _T_AM_StringContext* context = _T_AM_StringContext::_M_current;
+            if (context) {
+                if (const AMLStringOverlay* overlay = context->_M_overlay) {
+                    if (const _T_AM_StringView* v = overlay->find(ordinal))
+                        return std::string_view(v->_M_str, v->_M_length);
+                    if (overlay->_M_language)
+                        return getTranslatedView(ordinal, overlay->_M_language);
+                }
+                if (context->_M_language || context->_M_pinned)
+                    return getTranslatedView(ordinal, context->_M_language);
+            }
+            return getTranslatedView(ordinal, AMLStringLanguage::global());
+        }
+#endif
+
+#ifdef AMLSTRING_FIXED_LANGUAGE
+        /**
+         * @brief Selects plural form of compiled translation. Original strings follow "n != 1".
+         * @param rule plural rule of compiled catalog
+         * @param n count
+         * @return translated form
+         */
+        constexpr
+        std::string_view getPluralView(const AMLStringPluralRule& rule, unsigned long n) const noexcept
+        {
+            const std::string_view forms = getTranslatedView(nullptr);
+            if (forms.data() == _M_item->getSourceString())
+                return _T_AM_StringItemBase::cePluralForm(forms, n != 1);
+            return _T_AM_StringItemBase::cePluralForm(forms, rule.select(n));
+        }
+#else
+        /**
+         * @brief Selects plural form. Rule of language is used for items translated by it, rule
+         *        of table binding otherwise, so forms and rule always come from the same catalog.
+         *        Original strings always follow "n != 1".
+         * @param language language, nullptr for item strings
+         * @param table string table of item
+         * @param n count
+         * @return translated form
+         */
+        std::string_view getPluralView(const AMLStringLanguage* language, const _T_AM_StringList* table,
+                                       unsigned long n) const noexcept
+        {
+            const _T_AM_StringView* v = language ? language->find(_M_ordinal) : nullptr;
+            if (!v) {
+                language = table->binding();
+                v = language ? language->find(_M_ordinal) : nullptr;
+            }
+            // item translated by setTranslatedString() keeps rule of table
+            const AMLStringPluralRule& rule = v ? language->_M_plural_rule : table->pluralRule();
+            const std::string_view forms = v ? std::string_view(v->_M_str, v->_M_length) : getItemView();
+            if (forms.data() == _M_item->getSourceString())
+                return _T_AM_StringItemBase::cePluralForm(forms, n != 1);
+            return _T_AM_StringItemBase::cePluralForm(forms, rule.select(n));
+        }
+
+        /**
+         * @brief Sets translation of item, string must outlive all readers. Meant for a few strings,
+         *        tables are translated by bind().
+         */
+        void setTranslatedString(const char* str, size_t length);
+
+        void resetTranslatedString() noexcept;
+#endif
+    };
+
+    inline std::string_view _T_AM_StringItemBase::getTranslatedView() const noexcept
+    {
+        return _M_slot->getTranslatedView();
+    }
+
+#ifndef AMLSTRING_FIXED_LANGUAGE
+    inline void _T_AM_StringItemBase::setTranslatedString(const char* str)
+    {
+        _M_slot->setTranslatedString(str, _T_AM_StringItemBase::ceLength(str) - 1);
+    }
+
+    inline void _T_AM_StringItemBase::setTranslatedString(const char* str, size_t length)
+    {
+        _M_slot->setTranslatedString(str, length);
+    }
+
+    inline void _T_AM_StringItemBase::resetTranslatedString() noexcept
+    {
+        _M_slot->resetTranslatedString();
+    }
+#endif
+
+    inline uint32_t _T_AM_StringItemBase::getOrdinal() const noexcept
+    {
+        return _M_slot ? _M_slot->_M_ordinal : UNREGISTERED;
+    }
+
+    inline AMLString _T_AM_StringItemBase::getAMLString() const
+    {
+        AMLStringProvider prov(_M_slot);
+        AMLString amls(prov);
+        return amls;
+    }
+
+    AMLSTRING_VIEW_INLINE
+    std::string_view AMLStringProvider::view() const noexcept
+    {
+        return _M_slot->getTranslatedView();
+    }
+
+    AMLSTRING_VIEW_INLINE
+    std::string_view AMLString::view() const noexcept
+    {
+        return _M_provider.view();
+    }
+
+    AMLSTRING_VIEW_INLINE
+    std::string_view AMLString::view([[maybe_unused]] AMLStringLanguageId languageId) const noexcept
+    {
+#ifdef AMLSTRING_FIXED_LANGUAGE
+        // the only language is compiled in
+        return view();
+#else
+        return _M_provider._M_slot->getTranslatedView(AMLStringLanguage::language(languageId));
+#endif
+    }
+
+    AMLSTRING_VIEW_INLINE
+    const char* AMLString::c_str(AMLStringLanguageId languageId) const noexcept
+    {
+        return view(languageId).data();
+    }
+
+    AMLSTRING_VIEW_INLINE
+    size_t AMLString::size(AMLStringLanguageId languageId) const noexcept
+    {
+        return view(languageId).size();
+    }
+
+    constexpr
+    const _T_AM_StringItemBase* AMLString::item() const noexcept
+    {
+        return _M_provider._M_slot->_M_item;
+    }
+
+    constexpr
     const char* AMLString::getOriginalString() const noexcept
     {
-        return _M_provider._M_string_item->getOriginalString();
+        return item()->getSourceString();
     }
 
     constexpr
     size_t AMLString::getOriginalLength() const noexcept
     {
-        return _M_provider._M_string_item->getOriginalLength();
+        return item()->getSourceLength();
+    }
+
+    constexpr
+    std::string_view AMLString::getContext() const noexcept
+    {
+        return item()->getContext();
+    }
+
+    constexpr
+    uint64_t AMLString::id() const noexcept
+    {
+        return item()->getHash();
     }
 
     constexpr
     std::string_view AMLString::getOriginalStringView() const noexcept
     {
-        return std::string_view(_M_provider._M_string_item->getOriginalString(), _M_provider._M_string_item->getOriginalLength());
+        return std::string_view(item()->getSourceString(), item()->getSourceLength());
+    }
+
+    AMLSTRING_VIEW_INLINE
+    std::string_view AMLStringPluralProvider::view() const noexcept
+    {
+#ifdef AMLSTRING_FIXED_LANGUAGE
+        return _M_slot->getPluralView(*_M_rule, _M_count);
+#else
+        return _M_slot->getPluralView(AMLStringLanguage::active(), _M_table, _M_count);
+#endif
+    }
+
+    AMLSTRING_VIEW_INLINE
+    std::string_view AMLStringPlural::view() const noexcept
+    {
+        return _M_provider.view();
+    }
+
+    AMLSTRING_VIEW_INLINE
+    std::string_view AMLStringPlural::view([[maybe_unused]] AMLStringLanguageId languageId) const noexcept
+    {
+#ifdef AMLSTRING_FIXED_LANGUAGE
+        // the only language is compiled in
+        return view();
+#else
+        return _M_provider._M_slot->getPluralView(AMLStringLanguage::language(languageId),
+                                                  _M_provider._M_table, _M_provider._M_count);
+#endif
+    }
+
+    AMLSTRING_VIEW_INLINE
+    const char* AMLStringPlural::c_str(AMLStringLanguageId languageId) const noexcept
+    {
+        return view(languageId).data();
+    }
+
+    AMLSTRING_VIEW_INLINE
+    size_t AMLStringPlural::size(AMLStringLanguageId languageId) const noexcept
+    {
+        return view(languageId).size();
+    }
+
+    constexpr
+    const char* AMLStringPlural::getOriginalString() const noexcept
+    {
+        return _M_provider._M_slot->_M_item->getSourceString();
+    }
+
+    constexpr
+    std::string_view AMLStringPlural::getOriginalPluralString() const noexcept
+    {
+        const _T_AM_StringItemBase* item = _M_provider._M_slot->_M_item;
+        const size_t singular = _T_AM_StringItemBase::ceLength(item->getSourceString());
+        return std::string_view(item->getSourceString() + singular, item->getSourceLength() - singular);
+    }
+
+    constexpr
+    uint64_t AMLStringPlural::id() const noexcept
+    {
+        return _M_provider._M_slot->_M_item->getHash();
+    }
+
+#ifndef AMLSTRING_FIXED_LANGUAGE
+    class AMLStringHandleProvider
+    {
+        uint32_t _M_ordinal;
+
+        constexpr
+        AMLStringHandleProvider(uint32_t ordinal) :
+            _M_ordinal(ordinal)
+        {}
+
+        friend class AMLStringHandle;
+    public:
+        std::string_view view() const noexcept
+        {
+            return _T_AM_StringItemSlot::getTranslatedView(_M_ordinal);
+        }
+    };
+
+    using AMLStringHandleBase = AMBasicConstString<char, std::char_traits<char>, AMLStringHandleProvider>;
+
+    /**
+     *  @ingroup Strings
+     *  @brief String stored as 32-bit ordinal, half of AMLString, for large arrays of strings
+     *
+     *  Handle is resolved by ordinal directly in views of language, item string is taken from index
+     *  of slots built by _T_AM_StringList::finalizeAll(). Handles are not available in builds with
+     *  AMLSTRING_FIXED_LANGUAGE, strings are not registered there.
+     */
+    class AMLStringHandle: public AMLStringHandleBase
+    {
+    public:
+        /**
+         * @brief Creates handle of string, tables are finalized (and may allocate) if string is not indexed yet.
+         * @param string string returned by "_" function
+         */
+        AMLStringHandle(const AMLString& string);
+
+        /**
+         * @return string with the same translation
+         */
+        operator AMLString() const noexcept
+        {
+            return AMLString(AMLStringProvider(_T_AM_StringList::slot(_M_provider._M_ordinal)));
+        }
+
+        /**
+         * @return ordinal of string
+         */
+        uint32_t ordinal() const noexcept
+        {
+            return _M_provider._M_ordinal;
+        }
+
+        /**
+         * @return original (parameter of _ function) string (const char*)
+         */
+        const char* getOriginalString() const noexcept
+        {
+            return _T_AM_StringList::slot(_M_provider._M_ordinal)->_M_item->getSourceString();
+        }
+
+        /**
+         * @return FNV1a hash of original string, same as AMLString::id()
+         */
+        uint64_t id() const noexcept
+        {
+            return _T_AM_StringList::slot(_M_provider._M_ordinal)->_M_item->getHash();
+        }
+
+        /**
+         * @return translated string (string_view)
+         */
+        std::string_view view() const noexcept
+        {
+            return _T_AM_StringItemSlot::getTranslatedView(_M_provider._M_ordinal);
+        }
+
+        /**
+         * @param languageId slot of loaded language
+         * @return translated string in given language (string_view)
+         */
+        std::string_view view(AMLStringLanguageId languageId) const noexcept
+        {
+            return _T_AM_StringItemSlot::getTranslatedView(_M_provider._M_ordinal,
+                                                           AMLStringLanguage::language(languageId));
+        }
+
+        /**
+         * @brief Resolves many handles at once, the same as view() of each. Views of handles ahead
+         *        are prefetched, so latencies of lookups overlap.
+         * @param handles handles to resolve
+         * @param count number of handles
+         * @param views translated strings, count items
+         */
+        static void resolve(const AMLStringHandle* handles, size_t count, std::string_view* views) noexcept;
+    };
+
+    static_assert(sizeof(AMLStringHandle) == sizeof(uint32_t), "handle is not 32-bit");
+#endif
+
+#ifdef AMLSTRING_FIXED_LANGUAGE
+    constexpr bool _T_AM_StringFixedEqual(const char* a, const char* b)
+    {
+        for (; *a != '\0' && *a == *b; ++a, ++b) {}
+        return *a == *b;
+    }
+
+    /*
+     *  Perfect hash of generated catalog gives the first entry with hash, compiler evaluates two
+     *  probes instead of binary search for every string. Original string is returned if there is
+     *  no translation. Plural item takes all forms, singular item only the first one.
+     */
+    constexpr _T_AM_StringView _T_AM_StringFixedTranslation(const char* original, int originalLength)
+    {
+        const uint64_t hash = _T_AM_StringItemBase::ceHash(original);
+        size_t low = _T_AM_StringFixedCount;
+        if (_T_AM_StringFixedPerfectHash.size() != 0) {
+            low = _T_AM_StringFixedSlots[_T_AM_StringFixedPerfectHash(hash)];
+            if (_T_AM_StringFixedCatalog[low]._M_hash != hash)
+                low = _T_AM_StringFixedCount;
+        }
+        for (; low < _T_AM_StringFixedCount && _T_AM_StringFixedCatalog[low]._M_hash == hash; ++low) {
+            const _T_AM_StringFixedEntry& entry = _T_AM_StringFixedCatalog[low];
+            if (!_T_AM_StringFixedEqual(original, entry._M_original))
+                continue;
+            if (originalLength != _T_AM_StringItemBase::ceLength(original))
+                return {entry._M_translation, entry._M_length};
+            return {entry._M_translation,
+                    static_cast<uint32_t>(_T_AM_StringItemBase::ceLength(entry._M_translation) - 1)};
+        }
+        const int context = _T_AM_StringItemBase::ceContextLength(original);
+        return {original + context, static_cast<uint32_t>(originalLength - context - 1)};
     }
+#endif
 
     template<uint64_t tableHash, const char... chars>
     struct _T_AM_StringItemStatic: public _T_AM_StringItemBase
@@ -229,29 +1876,102 @@ namespace AMCore {
         static constexpr const char _M_original_str_data[sizeof...(chars)] = {chars...};
     public:
         constexpr
-        _T_AM_StringItemStatic() :
-            _T_AM_StringItemBase(_T_AM_StringItemStatic::_M_original_str_data)
+        _T_AM_StringItemStatic(_T_AM_StringItemSlot* slot, _T_AM_StringLink* link) :
+            _T_AM_StringItemBase(_T_AM_StringItemStatic::_M_original_str_data, sizeof...(chars), slot, link)
         {}
     };
 
+#if defined(AMLSTRING_FIXED_LANGUAGE)
+    /*
+     *  Item is a constant holding translation found at compile time, it is never registered.
+     */
+    template<uint64_t tableHash, const char... chars>
+    class _T_AM_StringItemWrapper
+    {
+        static constexpr _T_AM_StringItemStatic<tableHash, chars...> _M_static_item =
+                                                    _T_AM_StringItemStatic<tableHash, chars...>(nullptr, nullptr);
+        static constexpr _T_AM_StringItemSlot _M_slot = _T_AM_StringItemSlot(&_M_static_item,
+            _T_AM_StringFixedTranslation(_M_static_item.getOriginalString(), sizeof...(chars)));
+    public:
+        static constexpr const _T_AM_StringItemSlot* getTranslationObject()
+        {
+            return &_M_slot;
+        }
+    };
+#elif defined(AMLSTRING_SECTION_REGISTRATION)
+#if defined(__x86_64__) || defined(__i386__)
+#define AMLSTRING_SECTION_SYMBOL(n) "%p" #n
+#define AMLSTRING_SECTION_OPERAND "X"
+#elif defined(__aarch64__)
+#define AMLSTRING_SECTION_SYMBOL(n) "%c" #n
+#define AMLSTRING_SECTION_OPERAND "S"
+#else
+#error "AMLSTRING_SECTION_REGISTRATION is not supported on this architecture"
+#endif
+    /*
+     *  Items are not registered by static initializers. Every item places its entry into
+     *  "amlstring_items" section, tables find them on first use. GCC ignores section attribute
+     *  on template variables, so the entry is emitted by assembler.
+     */
+    template<uint64_t tableHash, const char... chars>
+    class _T_AM_StringItemWrapper
+    {
+        static _T_AM_StringItemSlot _M_slot;
+        static _T_AM_StringLink _M_link;
+        static constexpr _T_AM_StringItemStatic<tableHash, chars...> _M_static_item =
+                                                    _T_AM_StringItemStatic<tableHash, chars...>(&_M_slot, &_M_link);
+        static constexpr _T_AM_StringList* _M_table = _T_AM_StringListHolder<tableHash>::table();
+
+        __attribute__((used))
+        static void sectionEntry()
+        {
+            __asm__(".pushsection amlstring_items,\"aw\"\n\t"
+                    ".balign 16\n\t"
+                    ".dc.a " AMLSTRING_SECTION_SYMBOL(0) ", " AMLSTRING_SECTION_SYMBOL(1) "\n\t"
+                    ".popsection"
+                    :: AMLSTRING_SECTION_OPERAND(_M_table),
+                       AMLSTRING_SECTION_OPERAND(&_M_static_item));
+        }
+    public:
+        static constexpr _T_AM_StringItemSlot* getTranslationObject()
+        {
+            return &_M_slot;
+            sectionEntry();
+        }
+    };
+    template<uint64_t tableHash, const char... chars>
+    _T_AM_StringItemSlot _T_AM_StringItemWrapper<tableHash, chars...>::_M_slot =
+                                                    _T_AM_StringItemSlot(&_M_static_item);
+    template<uint64_t tableHash, const char... chars>
+    _T_AM_StringLink _T_AM_StringItemWrapper<tableHash, chars...>::_M_link(nullptr);
+#else
+    /*
+     *  Item is a read-only constant, only its slot and link are written at runtime
+     */
     template<uint64_t tableHash, const char... chars>
     class _T_AM_StringItemWrapper
     {
-        static _T_AM_StringItemStatic<tableHash, chars...> _M_static_item;
+        static _T_AM_StringItemSlot _M_slot;
+        static _T_AM_StringLink _M_link;
+        static constexpr _T_AM_StringItemStatic<tableHash, chars...> _M_static_item =
+                                                    _T_AM_StringItemStatic<tableHash, chars...>(&_M_slot, &_M_link);
         static _T_AM_StringList& _M_table;
     public:
-        static constexpr _T_AM_StringItemBase* getTranslationObject()
+        static constexpr _T_AM_StringItemSlot* getTranslationObject()
         {
-            return static_cast<_T_AM_StringItemBase*>(&_M_static_item);
+            return &_M_slot;
             _T_AM_StringList& tab = _M_table;
         }
     };
     template<uint64_t tableHash, const char... chars>
-    _T_AM_StringItemStatic<tableHash, chars...> _T_AM_StringItemWrapper<tableHash, chars...>::_M_static_item =
-                                                    _T_AM_StringItemStatic<tableHash, chars...>();
+    _T_AM_StringItemSlot _T_AM_StringItemWrapper<tableHash, chars...>::_M_slot =
+                                                    _T_AM_StringItemSlot(&_M_static_item);
+    template<uint64_t tableHash, const char... chars>
+    _T_AM_StringLink _T_AM_StringItemWrapper<tableHash, chars...>::_M_link(nullptr);
     template<uint64_t tableHash, const char... chars>
     _T_AM_StringList& _T_AM_StringItemWrapper<tableHash, chars...>::_M_table =
-        _T_AM_StringListHolder<tableHash>::registerItem(static_cast<_T_AM_StringItemBase*>(&_M_static_item));
+        _T_AM_StringListHolder<tableHash>::registerItem(const_cast<_T_AM_StringItemStatic<tableHash, chars...>*>(&_M_static_item));
+#endif
 
     /*
      *  @ingroup Strings
@@ -259,32 +1979,112 @@ namespace AMCore {
     class _T_AM_String
     {
         template<uint64_t tableHash, typename T, std::size_t... ints>
-        constexpr inline _T_AM_StringItemBase* getTextImpl(T data, std::index_sequence<ints...> int_seq)
+        constexpr inline const _T_AM_StringItemSlot* getTextImpl(T data, std::index_sequence<ints...>)
         {
             constexpr const char* src = data();
             return _T_AM_StringItemWrapper<tableHash, (src[ints])...>::getTranslationObject();
         }
+
+        /*
+         *  Item string is two strings joined by separator in place of terminating zero of the first,
+         *  "singular\0plural" or "context\x04original"
+         */
+        template<uint64_t tableHash, char separator, typename T, typename U, std::size_t... ints>
+        constexpr inline const _T_AM_StringItemSlot* getJoinedImpl(T first, U second,
+                                                                   std::index_sequence<ints...>)
+        {
+            constexpr const char* src = first();
+            constexpr const char* src2 = second();
+            constexpr size_t length = _T_AM_StringItemBase::ceLength(src);
+            return _T_AM_StringItemWrapper<tableHash, (ints + 1 < length ? src[ints] :
+                                                       ints + 1 == length ? separator : src2[ints - length])...>
+                       ::getTranslationObject();
+        }
     public:
 
-        template<typename T>
+        template<uint64_t tableHash = AMCEFNV1aAlgorithm::fnv1a64("default"), typename T>
         constexpr inline AMLString getTextImpl(T data)
         {
-            _T_AM_StringItemBase* stringItem = getTextImpl< AMCEFNV1aAlgorithm::fnv1a64("default")>
+            const _T_AM_StringItemSlot* slot = getTextImpl<tableHash>
                                                    (data, std::make_index_sequence<_T_AM_StringItemBase::ceLength(data())>{});
-            AMLStringProvider provider(stringItem);
+            AMLStringProvider provider(slot);
+            return AMLString(provider);
+        }
+
+        template<uint64_t tableHash = AMCEFNV1aAlgorithm::fnv1a64("default"), typename T, typename U>
+        constexpr inline AMLStringPlural getPluralImpl(T singular, U plural, unsigned long n)
+        {
+            const _T_AM_StringItemSlot* slot = getJoinedImpl<tableHash, '\0'>
+                (singular, plural, std::make_index_sequence<_T_AM_StringItemBase::ceLength(singular()) +
+                                                            _T_AM_StringItemBase::ceLength(plural())>{});
+#ifdef AMLSTRING_FIXED_LANGUAGE
+            AMLStringPluralProvider provider(slot, &_T_AM_StringFixedPluralRule, n);
+#else
+            AMLStringPluralProvider provider(slot, _T_AM_StringListHolder<tableHash>::table(), n);
+#endif
+            return AMLStringPlural(provider);
+        }
+
+        template<uint64_t tableHash = AMCEFNV1aAlgorithm::fnv1a64("default"), typename T, typename U>
+        constexpr inline AMLString getContextImpl(T context, U data)
+        {
+            const _T_AM_StringItemSlot* slot = getJoinedImpl<tableHash, '\x04'>
+                (context, data, std::make_index_sequence<_T_AM_StringItemBase::ceLength(context()) +
+                                                         _T_AM_StringItemBase::ceLength(data())>{});
+            AMLStringProvider provider(slot);
             return AMLString(provider);
         }
     };
 
-    template<typename T>
+    template<uint64_t tableHash = AMCEFNV1aAlgorithm::fnv1a64("default"), typename T>
     constexpr inline AMLString _T_AM_String_getTextImpl(T data)
     {
         _T_AM_String s;
-        return s.getTextImpl(data);
+        return s.template getTextImpl<tableHash>(data);
+    }
+
+    template<uint64_t tableHash = AMCEFNV1aAlgorithm::fnv1a64("default"), typename T, typename U>
+    constexpr inline AMLStringPlural _T_AM_String_getPluralImpl(T singular, U plural, unsigned long n)
+    {
+        _T_AM_String s;
+        return s.template getPluralImpl<tableHash>(singular, plural, n);
     }
 
+    template<uint64_t tableHash = AMCEFNV1aAlgorithm::fnv1a64("default"), typename T, typename U>
+    constexpr inline AMLString _T_AM_String_getContextImpl(T context, U data)
+    {
+        _T_AM_String s;
+        return s.template getContextImpl<tableHash>(context, data);
+    }
+
+
+}//namespace
+
+#if defined(AMLSTRING_SECTION_REGISTRATION) && !defined(AMLSTRING_FIXED_LANGUAGE)
+extern "C" {
+    extern const AMCore::_T_AM_StringSectionEntry __start_amlstring_items[] __attribute__((weak, visibility("hidden")));
+    extern const AMCore::_T_AM_StringSectionEntry __stop_amlstring_items[] __attribute__((weak, visibility("hidden")));
+}
+
+namespace AMCore {
+
+    // one range per module (executable or shared library)
+    inline _T_AM_StringSectionRange _T_AM_StringModuleSection __attribute__((visibility("hidden"))) = {nullptr, nullptr, nullptr};
+
+    namespace {
+        // only publishes section bounds, the section is scanned on first use of a table
+        __attribute__((constructor)) void _T_AM_StringRegisterModuleSection()
+        {
+            if (_T_AM_StringModuleSection._M_begin || +__start_amlstring_items == +__stop_amlstring_items)
+                return;
+            _T_AM_StringModuleSection._M_begin = __start_amlstring_items;
+            _T_AM_StringModuleSection._M_end = __stop_amlstring_items;
+            _T_AM_StringList::registerSection(&_T_AM_StringModuleSection);
+        }
+    }
 
 }//namespace
+#endif
 
 
 /**
@@ -294,6 +2094,63 @@ namespace AMCore {
  *  @returns translated string
  */
 #define _(string) AMCore::_T_AM_String_getTextImpl([]()constexpr{ return string;})
+
+/**
+ *  @ingroup Strings
+ *  @brief Adds string to stringtable of domain. Every domain loads, binds and unloads its catalog
+ *         independently.
+ *  @param domain stringtable name
+ *  @param string string
+ *  @returns translated string
+ */
+#define _D(domain, string) AMCore::_T_AM_String_getTextImpl<AMCore::AMCEFNV1aAlgorithm::fnv1a64(domain)>([]()constexpr{ return string;})
+
+/**
+ *  @ingroup Strings
+ *  @brief Adds string with plural form to localization stringtable
+ *  @param singular original singular string
+ *  @param plural original plural string
+ *  @param n count selecting the form
+ *  @returns translated form
+ */
+#define _N(singular, plural, n) AMCore::_T_AM_String_getPluralImpl([]()constexpr{ return singular;}, \
+                                                                   []()constexpr{ return plural;}, (n))
+
+/**
+ *  @ingroup Strings
+ *  @brief Adds string with plural form to stringtable of domain
+ *  @param domain stringtable name
+ *  @param singular original singular string
+ *  @param plural original plural string
+ *  @param n count selecting the form
+ *  @returns translated form
+ */
+#define _DN(domain, singular, plural, n) \
+    AMCore::_T_AM_String_getPluralImpl<AMCore::AMCEFNV1aAlgorithm::fnv1a64(domain)>([]()constexpr{ return singular;}, \
+                                                                                   []()constexpr{ return plural;}, (n))
+/**
+ *  @ingroup Strings
+ *  @brief Adds string with context (msgctxt) to localization stringtable. The same string in different
+ *         contexts is a different item with its own translation.
+ *  @param context context
+ *  @param string string
+ *  @returns translated string
+ */
+#define _C(context, string) AMCore::_T_AM_String_getContextImpl([]()constexpr{ return context;}, \
+                                                                []()constexpr{ return string;})
+
+/**
+ *  @ingroup Strings
+ *  @brief Adds string with context to stringtable of domain
+ *  @param domain stringtable name
+ *  @param context context
+ *  @param string string
+ *  @returns translated string
+ */
+#define _DC(domain, context, string) \
+    AMCore::_T_AM_String_getContextImpl<AMCore::AMCEFNV1aAlgorithm::fnv1a64(domain)>([]()constexpr{ return context;}, \
+                                                                                    []()constexpr{ return string;})
+
 #define _L(string) AMCore::_T_AM_String<wchar_t>::getTextImpl([]()constexpr{ return string;})
 
 /** @} */
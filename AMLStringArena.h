@@ -0,0 +1,116 @@
+/*!
+*   @file AMLStringArena.h
+*   This file is interface for storage of translated strings released at once.
+*
+*   @author Zdeněk Skulínek  &lt;<a href="mailto:zdenek.skulinek@seznam.cz">me@zdenekskulinek.cz</a>&gt;
+*/
+#ifndef AMLSTRINGARENA_H
+#define AMLSTRINGARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/**
+ *  @ingroup Strings
+ *  @{
+ */
+
+namespace AMCore {
+
+    /**
+     *  @ingroup Strings
+     *  @brief Bump pointer storage of strings owned by one language.
+     *
+     *  Strings are copied one after another into large blocks mapped from the system, not allocated
+     *  from heap, so languages loaded and released over and over do not fragment it. Identical strings
+     *  are stored once, index finding them is carved from the blocks as well. Index outgrown by rehash
+     *  stays unused in its block. Nothing is freed one by one, all blocks are unmapped by release() or
+     *  destructor.
+     *  Arena is not thread safe, strings are stored before language is published.
+     */
+    class AMLStringArena
+    {
+        struct Block
+        {
+            Block*  _M_next;
+            size_t  _M_size;        // including this header
+        };
+
+        Block*              _M_blocks;
+        char*               _M_top;
+        size_t              _M_left;
+        size_t              _M_size;
+        size_t              _M_capacity;
+        bool                _M_huge_pages;
+        std::string_view*   _M_index;           // open addressing, power of two, empty if null
+        size_t              _M_index_size;
+        size_t              _M_index_count;
+
+        bool grow(size_t size) noexcept;
+        std::string_view* slot(std::string_view str) noexcept;
+        bool rehash() noexcept;
+    public:
+        static constexpr size_t BLOCK_SIZE = 64 * 1024;
+        static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+        /**
+         * @param hugePages advise kernel to back blocks by transparent huge pages
+         */
+        explicit AMLStringArena(bool hugePages = false) noexcept;
+        ~AMLStringArena();
+        AMLStringArena(const AMLStringArena&) = delete;
+        AMLStringArena& operator=(const AMLStringArena&) = delete;
+
+        /**
+         * @brief Blocks mapped later are advised by madvise(MADV_HUGEPAGE). Blocks are then rounded to
+         *        HUGE_PAGE_SIZE, it pays off for languages of thousands of strings only.
+         * @param hugePages true to use huge pages
+         */
+        void useHugePages(bool hugePages) noexcept
+        {
+            _M_huge_pages = hugePages;
+        }
+
+        /**
+         * @brief Makes room for size bytes in one block, so strings stored next are contiguous.
+         * @param size bytes including terminating zeros
+         * @return false if memory cannot be mapped
+         */
+        bool reserve(size_t size) noexcept;
+
+        /**
+         * @brief Copies string with terminating zero. String equal to one stored before is not copied
+         *        again. String may contain zeros, e.g. plural forms.
+         * @param str string
+         * @return stored string valid until release(), nullptr data if memory cannot be mapped
+         */
+        std::string_view store(std::string_view str) noexcept;
+
+        /**
+         * @return bytes taken by stored strings including terminating zeros
+         */
+        size_t size() const noexcept
+        {
+            return _M_size;
+        }
+
+        /**
+         * @return bytes of all mapped blocks
+         */
+        size_t capacity() const noexcept
+        {
+            return _M_capacity;
+        }
+
+        /**
+         * @brief Unmaps all blocks. All stored strings become invalid.
+         */
+        void release() noexcept;
+    };
+
+}//namespace
+
+/** @} */
+
+#endif /* AMLSTRINGARENA_H */
@@ -0,0 +1,277 @@
+/*!
+*   @file AMLStringCatalog.h
+*   This file is interface for read-only access to GNU <b>.mo</b> message catalogs.
+*
+*   @author Zdeněk Skulínek  &lt;<a href="mailto:zdenek.skulinek@seznam.cz">me@zdenekskulinek.cz</a>&gt;
+*/
+#ifndef AMLSTRINGCATALOG_H
+#define AMLSTRINGCATALOG_H
+
+#include <cstddef>
+#include <cstdint>
+#include "AMLStringPerfectHash.h"
+
+/**
+ *  @ingroup Strings
+ *  @{
+ */
+
+namespace AMCore {
+
+    /**
+     *  @ingroup Strings
+     *  @brief Message catalog (<b>.mo</b> file) mapped into memory.
+     *
+     *  The file is mapped read-only and shared, so translated strings are never copied. All offsets
+     *  are validated by open(), therefore accessors do not check anything and never call strlen.
+     *  Returned pointers are valid until the catalog is closed.
+     */
+    class AMLStringCatalog
+    {
+        const char*     _M_data;
+        size_t          _M_size;
+        uint32_t        _M_count;
+        const uint32_t* _M_original_table;
+        const uint32_t* _M_translation_table;
+        bool            _M_swapped;
+
+        uint32_t word(const uint32_t* table, uint32_t index) const noexcept;
+        bool validString(const uint32_t* table, uint32_t index) const noexcept;
+    public:
+        AMLStringCatalog() noexcept;
+        ~AMLStringCatalog();
+        AMLStringCatalog(const AMLStringCatalog&) = delete;
+        AMLStringCatalog& operator=(const AMLStringCatalog&) = delete;
+
+        /**
+         * @brief Maps <b>.mo</b> file into memory.
+         * @param fileName name of file
+         * @return true if file was mapped and has valid format
+         */
+        bool open(const char* fileName);
+
+        /**
+         * @brief Unmaps file. All strings obtained from catalog become invalid.
+         */
+        void close() noexcept;
+
+        /**
+         * @return true if catalog is mapped
+         */
+        bool isOpen() const noexcept
+        {
+            return _M_data != nullptr;
+        }
+
+        /**
+         * @return mapped file
+         */
+        const char* data() const noexcept
+        {
+            return _M_data;
+        }
+
+        /**
+         * @return size of mapped file
+         */
+        size_t size() const noexcept
+        {
+            return _M_size;
+        }
+
+        /**
+         * @brief Hashes whole file, catalogs with the same checksum and size are taken as equal.
+         *        Every page of the file is read, the checksum is not stored anywhere.
+         * @return checksum of file
+         */
+        uint64_t checksum() const noexcept;
+
+        /**
+         * @param str any pointer
+         * @return true if str points into mapped file
+         */
+        bool contains(const char* str) const noexcept
+        {
+            return str >= _M_data && str < _M_data + _M_size;
+        }
+
+        /**
+         * @return number of strings in catalog (including header entry)
+         */
+        uint32_t count() const noexcept
+        {
+            return _M_count;
+        }
+
+        /**
+         * @return original (msgid) string at index
+         */
+        const char* getOriginalString(uint32_t index) const noexcept
+        {
+            return _M_data + word(_M_original_table, 2 * index + 1);
+        }
+
+        /**
+         * @return original (msgid) string length at index
+         */
+        size_t getOriginalLength(uint32_t index) const noexcept
+        {
+            return word(_M_original_table, 2 * index);
+        }
+
+        /**
+         * @return translated (msgstr) string at index
+         */
+        const char* getTranslatedString(uint32_t index) const noexcept
+        {
+            return _M_data + word(_M_translation_table, 2 * index + 1);
+        }
+
+        /**
+         * @return translated (msgstr) string length at index
+         */
+        size_t getTranslatedLength(uint32_t index) const noexcept
+        {
+            return word(_M_translation_table, 2 * index);
+        }
+
+        /**
+         * @brief Binary search for original string. Catalog originals are sorted.
+         * @param original original (msgid) string
+         * @return index of string or count() if not found
+         */
+        uint32_t find(const char* original) const noexcept;
+
+        /**
+         * @return translation of catalog header (msgid "") or empty string
+         */
+        const char* header() const noexcept
+        {
+            return (_M_count && getOriginalLength(0) == 0) ? getTranslatedString(0) : "";
+        }
+    };
+
+    /**
+     *  @ingroup Strings
+     *  @brief One translation of compiled catalog. Strings are stored as offsets into catalog string
+     *         data, so generated tables need no relocation and stay in read-only data.
+     */
+    struct AMLStringCompiledEntry
+    {
+        uint64_t _M_hash;                ///< FNV1a hash of original string, same as used by _()
+        uint32_t _M_original_offset;
+        uint32_t _M_original_length;
+        uint32_t _M_translation_offset;
+        uint32_t _M_translation_length;
+    };
+
+    /**
+     *  @ingroup Strings
+     *  @brief Message catalog compiled from <b>.po</b> file into C++ at build time
+     *         (see amlstring_compile_catalog() CMake function).
+     *
+     *  Entries are sorted by hash and indexed by minimal perfect hash of distinct hashes, so entry of
+     *  a string is found in two probes. Generated catalog registers itself under its name, so selecting
+     *  a language needs no file input and no parsing.
+     */
+    class AMLStringCompiledCatalog
+    {
+        const char*                   _M_name;
+        const char*                   _M_header;
+        const char*                   _M_data;
+        const AMLStringCompiledEntry* _M_entries;
+        uint32_t                      _M_count;
+        AMLStringPerfectHash          _M_perfect_hash;
+        const uint32_t*               _M_slots;         // first entry of hash in every slot
+        AMLStringCompiledCatalog*     _M_next;
+        static AMLStringCompiledCatalog* _M_root;
+    public:
+        /**
+         * @param name catalog name
+         * @param header translation of catalog header
+         * @param data all strings
+         * @param entries entries sorted by hash
+         * @param count number of entries
+         * @param perfectHash perfect hash of distinct hashes of entries, find() searches binary without it
+         * @param slots index of first entry with hash of every slot of perfect hash
+         */
+        AMLStringCompiledCatalog(const char* name, const char* header, const char* data,
+                                 const AMLStringCompiledEntry* entries, uint32_t count,
+                                 AMLStringPerfectHash perfectHash = AMLStringPerfectHash(),
+                                 const uint32_t* slots = nullptr) noexcept;
+        ~AMLStringCompiledCatalog();
+        AMLStringCompiledCatalog(const AMLStringCompiledCatalog&) = delete;
+        AMLStringCompiledCatalog& operator=(const AMLStringCompiledCatalog&) = delete;
+
+        /**
+         * @param name catalog name given to amlstring_compile_catalog()
+         * @return compiled catalog linked into program or nullptr
+         */
+        static const AMLStringCompiledCatalog* find(const char* name) noexcept;
+
+        /**
+         * @return catalog name
+         */
+        const char* name() const noexcept
+        {
+            return _M_name;
+        }
+
+        /**
+         * @return translation of catalog header (msgid "")
+         */
+        const char* header() const noexcept
+        {
+            return _M_header;
+        }
+
+        /**
+         * @return number of translations (without header)
+         */
+        uint32_t count() const noexcept
+        {
+            return _M_count;
+        }
+
+        /**
+         * @return translation entry at index
+         */
+        const AMLStringCompiledEntry& entry(uint32_t index) const noexcept
+        {
+            return _M_entries[index];
+        }
+
+        /**
+         * @return original string of entry
+         */
+        const char* getOriginalString(const AMLStringCompiledEntry& entry) const noexcept
+        {
+            return _M_data + entry._M_original_offset;
+        }
+
+        /**
+         * @return translated string of entry
+         */
+        const char* getTranslatedString(const AMLStringCompiledEntry& entry) const noexcept
+        {
+            return _M_data + entry._M_translation_offset;
+        }
+
+        /**
+         * @brief Finds first entry with hash by perfect hash, or by binary search in catalog without it.
+         * @param hash FNV1a hash of original string
+         * @return index of first entry with the hash or count() if not found
+         */
+        uint32_t find(uint64_t hash) const noexcept;
+    };
+
+    inline uint32_t AMLStringCatalog::word(const uint32_t* table, uint32_t index) const noexcept
+    {
+        return _M_swapped ? __builtin_bswap32(table[index]) : table[index];
+    }
+
+}//namespace
+
+/** @} */
+
+#endif /* AMLSTRINGCATALOG_H */
@@ -0,0 +1,104 @@
+/*!
+*   @file AMLStringLoader.h
+*   This file is interface for loading of <b>.mo</b> files in background while program starts.
+*
+*   @author Zdeněk Skulínek  &lt;<a href="mailto:zdenek.skulinek@seznam.cz">me@zdenekskulinek.cz</a>&gt;
+*/
+#ifndef AMLSTRINGLOADER_H
+#define AMLSTRINGLOADER_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "AMLString.h"
+
+/**
+ *  @ingroup Strings
+ *  @{
+ */
+
+namespace AMCore {
+
+    /**
+     *  @ingroup Strings
+     *  @brief Loads and binds languages on background threads.
+     *
+     *  Every language is loaded into new AMLStringLanguage which is published (activated or stored
+     *  into slot) only when it is completely bound. Until then readers get whatever was published
+     *  before, original strings if nothing was. Program may serve its first frame or request while
+     *  translations are loading and wait for the returned future only where it needs them.
+     *  Language replaced by the loaded one is retired (AMLStringLanguage::retire()) unless it is
+     *  still published in another slot, so it must have been allocated by new. Program deletes it
+     *  by AMLStringLanguage::reclaim().
+     *
+     *  Catalog of a large table is bound by several threads, each looks up its range of msgids.
+     *  Languages loaded at the same time share bindThreads, they never use more threads together.
+     */
+    class AMLStringLoader
+    {
+        struct Task;
+
+        std::vector<std::thread>    _M_threads;
+        std::mutex                  _M_mutex;           // guards tasks and stopping
+        std::condition_variable     _M_queued;
+        std::deque<Task*>           _M_tasks;
+        bool                        _M_stopping;
+        unsigned                    _M_bind_threads;
+
+        std::future<int> add(int languageId, const char* name, const char* table, std::function<void(int)> done);
+        int load(const Task& task);
+        void run();
+    public:
+        /**
+         * @param threads number of languages loaded at the same time
+         * @param bindThreads number of threads binding all languages loaded at the same time, every
+         *        language gets bindThreads / threads of them (at least its loading thread)
+         */
+        explicit AMLStringLoader(unsigned threads = 1, unsigned bindThreads = std::thread::hardware_concurrency());
+
+        /**
+         * @brief Finishes queued languages and stops threads.
+         */
+        ~AMLStringLoader();
+        AMLStringLoader(const AMLStringLoader&) = delete;
+        AMLStringLoader& operator=(const AMLStringLoader&) = delete;
+
+        /**
+         * @brief Queues <b>.mo</b> file, the language is activated for all threads when it is bound.
+         *        Catalog of a named domain is bound to its table instead (see _T_AM_StringList::Load()).
+         * @param name file name
+         * @param table string table name
+         * @return number of translated items or -1 if file or table cannot be found, holds exception
+         *         thrown while language was loaded (e.g. std::bad_alloc)
+         */
+        std::future<int> load(const char* name, const char* table = "default");
+
+        /**
+         * @brief Queues <b>.mo</b> file, the language is published into slot when it is bound.
+         * @param languageId slot of language
+         * @param name file name
+         * @param table string table name
+         * @return number of translated items or -1 if file or table cannot be found, holds exception
+         *         thrown while language was loaded
+         */
+        std::future<int> load(AMLStringLanguageId languageId, const char* name, const char* table = "default");
+
+        /**
+         * @brief Same as load(), done is called by loading thread after language is published.
+         * @param languageId slot of language
+         * @param name file name
+         * @param table string table name
+         * @param done receives number of translated items or -1, also if loading threw, must not throw
+         */
+        void load(AMLStringLanguageId languageId, const char* name, const char* table, std::function<void(int)> done);
+    };
+
+}//namespace
+
+/** @} */
+
+#endif /* AMLSTRINGLOADER_H */
@@ -0,0 +1,189 @@
+/*!
+*   @file AMLStringPerfectHash.h
+*   This file is interface for minimal perfect hash of msgids of a catalog, built by AMLStringPoCompiler.
+*
+*   @author Zdeněk Skulínek  &lt;<a href="mailto:zdenek.skulinek@seznam.cz">me@zdenekskulinek.cz</a>&gt;
+*/
+#ifndef AMLSTRINGPERFECTHASH_H
+#define AMLSTRINGPERFECTHASH_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ *  @ingroup Strings
+ *  @{
+ */
+
+namespace AMCore {
+
+    /**
+     *  @ingroup Strings
+     *  @brief Minimal perfect hash of FNV1a hashes of msgids of one catalog (hash and displace).
+     *
+     *  Keys are spread into buckets of about BUCKET_SIZE keys. Every bucket has displacement chosen
+     *  by build() so that its keys fall into free slots, n keys take exactly slots 0 .. n-1. Lookup
+     *  reads one displacement and computes the slot, there are no collision chains. Key which was not
+     *  built in maps to any slot, caller compares key stored in slot. Displacements are generated
+     *  as constant tables by AMLStringPoCompiler, lookup can be evaluated by compiler.
+     */
+    class AMLStringPerfectHash
+    {
+        const uint32_t* _M_displacements;
+        uint32_t        _M_buckets;
+        uint32_t        _M_count;
+
+        /*
+         *  Finalizer of MurmurHash3, FNV1a alone spreads short strings badly in high bits
+         */
+        static constexpr uint64_t mix(uint64_t hash) noexcept
+        {
+            hash ^= hash >> 33;
+            hash *= 0xff51afd7ed558ccdULL;
+            hash ^= hash >> 33;
+            hash *= 0xc4ceb9fe1a85ec53ULL;
+            hash ^= hash >> 33;
+            return hash;
+        }
+
+        /*
+         *  Maps x uniformly to 0 .. n-1 without division
+         */
+        static constexpr uint32_t range(uint32_t x, uint32_t n) noexcept
+        {
+            return static_cast<uint32_t>((static_cast<uint64_t>(x) * n) >> 32);
+        }
+
+        static constexpr uint32_t bucket(uint64_t mixed, uint32_t buckets) noexcept
+        {
+            return range(static_cast<uint32_t>(mixed >> 32), buckets);
+        }
+
+        static constexpr uint32_t slot(uint64_t mixed, uint32_t displacement, uint32_t count) noexcept
+        {
+            return range(static_cast<uint32_t>(mix(mixed ^ (displacement * 0x9e3779b97f4a7c15ULL))), count);
+        }
+
+        /*
+         *  Displacements tried per bucket. The last single key hits one free slot of count with
+         *  probability 1 - e^-64, so only keys no displacement can separate exhaust it.
+         */
+        static uint32_t maxDisplacement(uint32_t count) noexcept
+        {
+            return static_cast<uint32_t>(std::min<uint64_t>(uint64_t(std::max(count, 1u)) * 64, UINT32_MAX));
+        }
+    public:
+        static constexpr uint32_t BUCKET_SIZE = 4;
+
+        constexpr AMLStringPerfectHash() noexcept :
+            _M_displacements(nullptr),
+            _M_buckets(0),
+            _M_count(0)
+        {}
+
+        /**
+         * @param displacements table filled by build()
+         * @param buckets bucketCount(count)
+         * @param count number of keys
+         */
+        constexpr AMLStringPerfectHash(const uint32_t* displacements, uint32_t buckets, uint32_t count) noexcept :
+            _M_displacements(displacements),
+            _M_buckets(buckets),
+            _M_count(count)
+        {}
+
+        /**
+         * @param count number of keys
+         * @return number of displacements
+         */
+        static constexpr uint32_t bucketCount(uint32_t count) noexcept
+        {
+            return count / BUCKET_SIZE + 1;
+        }
+
+        /**
+         * @return number of keys and slots, 0 if there is no table
+         */
+        constexpr uint32_t size() const noexcept
+        {
+            return _M_count;
+        }
+
+        /**
+         * @param hash FNV1a hash of original string
+         * @return slot of key, any slot if key was not built in, size() must not be 0
+         */
+        constexpr uint32_t operator()(uint64_t hash) const noexcept
+        {
+            const uint64_t mixed = mix(hash);
+            return slot(mixed, _M_displacements[bucket(mixed, _M_buckets)], _M_count);
+        }
+
+        /**
+         * @brief Finds displacements of all buckets. The largest buckets are placed first, while most
+         *        slots are free, single keys at the end try displacements until they hit a free slot.
+         * @param hashes distinct keys
+         * @param count number of keys
+         * @param displacements receives bucketCount(count) displacements
+         * @return false if keys are not distinct or a bucket found no free slots, displacements are
+         *         not valid then
+         */
+        static bool build(const uint64_t* hashes, uint32_t count, std::vector<uint32_t>& displacements)
+        {
+            const uint32_t buckets = bucketCount(count);
+            displacements.assign(buckets, 0);
+            std::vector<std::pair<uint32_t, uint64_t>> keys;
+            keys.reserve(count);
+            for (uint32_t i = 0; i < count; ++i) {
+                const uint64_t mixed = mix(hashes[i]);
+                keys.emplace_back(bucket(mixed, buckets), mixed);
+            }
+            std::sort(keys.begin(), keys.end());
+            // mix is a bijection, equal mixed keys are equal keys
+            for (size_t i = 1; i < keys.size(); ++i) {
+                if (keys[i] == keys[i - 1])
+                    return false;
+            }
+            std::vector<std::pair<uint32_t, uint32_t>> ranges;  // size, first key
+            for (size_t first = 0, last; first < keys.size(); first = last) {
+                for (last = first + 1; last < keys.size() && keys[last].first == keys[first].first; ++last) {}
+                ranges.emplace_back(static_cast<uint32_t>(last - first), static_cast<uint32_t>(first));
+            }
+            std::stable_sort(ranges.begin(), ranges.end(), [](const std::pair<uint32_t, uint32_t>& a,
+                                                              const std::pair<uint32_t, uint32_t>& b) {
+                return a.first > b.first;
+            });
+            std::vector<bool> taken(count, false);
+            std::vector<uint32_t> slots;
+            const uint32_t tries = maxDisplacement(count);
+            for (const std::pair<uint32_t, uint32_t>& range : ranges) {
+                for (uint32_t displacement = 0; ; ++displacement) {
+                    if (displacement == tries)
+                        return false;
+                    slots.clear();
+                    for (uint32_t i = range.second; i < range.second + range.first; ++i) {
+                        const uint32_t s = slot(keys[i].second, displacement, count);
+                        if (taken[s] || std::find(slots.begin(), slots.end(), s) != slots.end())
+                            break;
+                        slots.push_back(s);
+                    }
+                    if (slots.size() == range.first) {
+                        for (uint32_t s : slots)
+                            taken[s] = true;
+                        displacements[keys[range.second].first] = displacement;
+                        break;
+                    }
+                }
+            }
+            return true;
+        }
+    };
+
+}//namespace
+
+/** @} */
+
+#endif /* AMLSTRINGPERFECTHASH_H */
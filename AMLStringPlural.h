@@ -0,0 +1,428 @@
+/*!
+*   @file AMLStringPlural.h
+*   This file is interface for evaluation of gettext <b>Plural-Forms</b> expressions.
+*
+*   @author Zdeněk Skulínek  &lt;<a href="mailto:zdenek.skulinek@seznam.cz">me@zdenekskulinek.cz</a>&gt;
+*/
+#ifndef AMLSTRINGPLURAL_H
+#define AMLSTRINGPLURAL_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ *  @ingroup Strings
+ *  @{
+ */
+
+namespace AMCore {
+
+    /**
+     *  @ingroup Strings
+     *  @brief Plural rule of a catalog, parsed once from <b>Plural-Forms</b> header.
+     *
+     *  Expression is compiled into a small stack bytecode. Rules of common language families are
+     *  recognized and evaluated by specialized code, so selecting a form costs a few comparisons.
+     *  All functions are constexpr, rule of a catalog compiled into program is parsed by compiler.
+     */
+    class AMLStringPluralRule
+    {
+    public:
+        /**
+         * @brief Rules with specialized evaluation, other rules are interpreted.
+         */
+        enum Family : uint8_t
+        {
+            GERMANIC,       ///< n != 1 (English, German, ...), also used without catalog
+            ONE_FORM,       ///< 0 (Japanese, Chinese, ...)
+            FRENCH,         ///< n > 1
+            CZECH,          ///< n == 1 ? 0 : n >= 2 && n <= 4 ? 1 : 2 (Czech, Slovak)
+            EAST_SLAVIC,    ///< n % 10 == 1 && n % 100 != 11 ? 0 : n % 10 >= 2 && n % 10 <= 4 && (n % 100 < 10 || n % 100 >= 20) ? 1 : 2
+            POLISH,         ///< n == 1 ? 0 : n % 10 >= 2 && n % 10 <= 4 && (n % 100 < 10 || n % 100 >= 20) ? 1 : 2
+            BYTECODE        ///< any other expression
+        };
+
+        enum Opcode : uint32_t
+        {
+            OP_N, OP_CONST, OP_NOT, OP_MUL, OP_DIV, OP_MOD, OP_ADD, OP_SUB,
+            OP_LT, OP_LE, OP_GT, OP_GE, OP_EQ, OP_NE, OP_AND, OP_OR, OP_SELECT
+        };
+
+        static constexpr size_t MAX_CODE = 96;
+        static constexpr size_t MAX_STACK = 16;
+
+    private:
+        Family   _M_family = GERMANIC;
+        uint8_t  _M_nplurals = 2;
+        uint8_t  _M_length = 0;
+        uint32_t _M_code[MAX_CODE] = {};
+
+        friend class _T_AM_StringPluralParser;
+
+        constexpr uint32_t evaluate(unsigned long n) const noexcept;
+        constexpr bool sameCode(const AMLStringPluralRule& other) const noexcept;
+    public:
+        constexpr AMLStringPluralRule() noexcept {}
+
+        /**
+         * @brief Parses plural expression.
+         * @param expression C expression of n, ends with ';', new line or end of string
+         * @param nplurals number of forms
+         * @return true if expression is valid, rule is not changed otherwise
+         */
+        constexpr bool parse(const char* expression, uint8_t nplurals) noexcept;
+
+        /**
+         * @brief Parses <b>Plural-Forms</b> line of catalog header.
+         * @param header translation of empty msgid
+         * @return true if header contains valid plural forms, rule is not changed otherwise
+         */
+        constexpr bool parseHeader(const char* header) noexcept;
+
+        /**
+         * @return number of forms
+         */
+        constexpr uint8_t forms() const noexcept
+        {
+            return _M_nplurals;
+        }
+
+        /**
+         * @return family of rule, BYTECODE if it is interpreted
+         */
+        constexpr Family family() const noexcept
+        {
+            return _M_family;
+        }
+
+        /**
+         * @param n count
+         * @return index of plural form
+         */
+        constexpr uint32_t select(unsigned long n) const noexcept
+        {
+            switch (_M_family) {
+            case GERMANIC:
+                return n != 1;
+            case ONE_FORM:
+                return 0;
+            case FRENCH:
+                return n > 1;
+            case CZECH:
+                return n == 1 ? 0 : (n >= 2 && n <= 4) ? 1 : 2;
+            case EAST_SLAVIC:
+                return (n % 10 == 1 && n % 100 != 11) ? 0 :
+                       (n % 10 >= 2 && n % 10 <= 4 && (n % 100 < 10 || n % 100 >= 20)) ? 1 : 2;
+            case POLISH:
+                return n == 1 ? 0 : (n % 10 >= 2 && n % 10 <= 4 && (n % 100 < 10 || n % 100 >= 20)) ? 1 : 2;
+            default:
+                return evaluate(n);
+            }
+        }
+    };
+
+    /*
+     *  Recursive descent parser of C expression subset used by Plural-Forms, emits postfix bytecode.
+     *  Conditional operator evaluates both branches, plural expressions have no side effects.
+     */
+    class _T_AM_StringPluralParser
+    {
+        const char*          _M_p;
+        AMLStringPluralRule& _M_rule;
+        size_t               _M_depth;
+        size_t               _M_max_depth;
+        bool                 _M_ok;
+
+        constexpr void emit(uint32_t word, int stackChange)
+        {
+            if (_M_rule._M_length >= AMLStringPluralRule::MAX_CODE) {
+                _M_ok = false;
+                return;
+            }
+            _M_rule._M_code[_M_rule._M_length++] = word;
+            _M_depth += stackChange;
+            if (_M_depth > _M_max_depth)
+                _M_max_depth = _M_depth;
+        }
+
+        constexpr void skip()
+        {
+            while (*_M_p == ' ' || *_M_p == '\t')
+                ++_M_p;
+        }
+
+        constexpr bool accept(const char* token)
+        {
+            skip();
+            size_t i = 0;
+            for (; token[i] != '\0'; ++i) {
+                if (_M_p[i] != token[i])
+                    return false;
+            }
+            _M_p += i;
+            return true;
+        }
+
+        constexpr void expect(const char* token)
+        {
+            if (!accept(token))
+                _M_ok = false;
+        }
+
+        constexpr void primary()
+        {
+            skip();
+            if (!_M_ok)
+                return;
+            if (accept("(")) {
+                conditional();
+                expect(")");
+            }
+            else if (accept("!")) {
+                primary();
+                emit(AMLStringPluralRule::OP_NOT, 0);
+            }
+            else if (accept("n")) {
+                emit(AMLStringPluralRule::OP_N, 1);
+            }
+            else if (*_M_p >= '0' && *_M_p <= '9') {
+                uint32_t value = 0;
+                for (; *_M_p >= '0' && *_M_p <= '9'; ++_M_p)
+                    value = value * 10 + (*_M_p - '0');
+                emit(AMLStringPluralRule::OP_CONST, 1);
+                emit(value, 0);
+            }
+            else
+                _M_ok = false;
+        }
+
+        constexpr void multiplicative()
+        {
+            primary();
+            while (_M_ok) {
+                if (accept("*"))
+                    { primary(); emit(AMLStringPluralRule::OP_MUL, -1); }
+                else if (accept("/"))
+                    { primary(); emit(AMLStringPluralRule::OP_DIV, -1); }
+                else if (accept("%"))
+                    { primary(); emit(AMLStringPluralRule::OP_MOD, -1); }
+                else
+                    break;
+            }
+        }
+
+        constexpr void additive()
+        {
+            multiplicative();
+            while (_M_ok) {
+                if (accept("+"))
+                    { multiplicative(); emit(AMLStringPluralRule::OP_ADD, -1); }
+                else if (accept("-"))
+                    { multiplicative(); emit(AMLStringPluralRule::OP_SUB, -1); }
+                else
+                    break;
+            }
+        }
+
+        constexpr void relational()
+        {
+            additive();
+            while (_M_ok) {
+                if (accept("<="))
+                    { additive(); emit(AMLStringPluralRule::OP_LE, -1); }
+                else if (accept(">="))
+                    { additive(); emit(AMLStringPluralRule::OP_GE, -1); }
+                else if (accept("<"))
+                    { additive(); emit(AMLStringPluralRule::OP_LT, -1); }
+                else if (accept(">"))
+                    { additive(); emit(AMLStringPluralRule::OP_GT, -1); }
+                else
+                    break;
+            }
+        }
+
+        constexpr void equality()
+        {
+            relational();
+            while (_M_ok) {
+                if (accept("=="))
+                    { relational(); emit(AMLStringPluralRule::OP_EQ, -1); }
+                else if (accept("!="))
+                    { relational(); emit(AMLStringPluralRule::OP_NE, -1); }
+                else
+                    break;
+            }
+        }
+
+        constexpr void logicalAnd()
+        {
+            equality();
+            while (_M_ok && accept("&&")) {
+                equality();
+                emit(AMLStringPluralRule::OP_AND, -1);
+            }
+        }
+
+        constexpr void logicalOr()
+        {
+            logicalAnd();
+            while (_M_ok && accept("||")) {
+                logicalAnd();
+                emit(AMLStringPluralRule::OP_OR, -1);
+            }
+        }
+
+        constexpr void conditional()
+        {
+            logicalOr();
+            if (_M_ok && accept("?")) {
+                conditional();
+                expect(":");
+                conditional();
+                emit(AMLStringPluralRule::OP_SELECT, -2);
+            }
+        }
+
+    public:
+        constexpr _T_AM_StringPluralParser(const char* expression, AMLStringPluralRule& rule) :
+            _M_p(expression),
+            _M_rule(rule),
+            _M_depth(0),
+            _M_max_depth(0),
+            _M_ok(true)
+        {}
+
+        constexpr bool parse()
+        {
+            _M_rule._M_length = 0;
+            conditional();
+            skip();
+            return _M_ok && (*_M_p == ';' || *_M_p == '\n' || *_M_p == '\r' || *_M_p == '\0') &&
+                   _M_depth == 1 && _M_max_depth <= AMLStringPluralRule::MAX_STACK;
+        }
+    };
+
+    constexpr uint32_t AMLStringPluralRule::evaluate(unsigned long n) const noexcept
+    {
+        uint64_t stack[MAX_STACK] = {};
+        size_t top = 0;
+        for (size_t i = 0; i < _M_length; ++i) {
+            const uint32_t op = _M_code[i];
+            if (op == OP_N) {
+                stack[top++] = n;
+                continue;
+            }
+            if (op == OP_CONST) {
+                stack[top++] = _M_code[++i];
+                continue;
+            }
+            if (op == OP_NOT) {
+                stack[top - 1] = !stack[top - 1];
+                continue;
+            }
+            if (op == OP_SELECT) {
+                top -= 2;
+                stack[top - 1] = stack[top - 1] ? stack[top] : stack[top + 1];
+                continue;
+            }
+            const uint64_t b = stack[--top];
+            uint64_t& a = stack[top - 1];
+            switch (op) {
+            case OP_MUL: a = a * b; break;
+            case OP_DIV: a = b ? a / b : 0; break;
+            case OP_MOD: a = b ? a % b : 0; break;
+            case OP_ADD: a = a + b; break;
+            case OP_SUB: a = a - b; break;
+            case OP_LT:  a = a < b; break;
+            case OP_LE:  a = a <= b; break;
+            case OP_GT:  a = a > b; break;
+            case OP_GE:  a = a >= b; break;
+            case OP_EQ:  a = a == b; break;
+            case OP_NE:  a = a != b; break;
+            case OP_AND: a = a && b; break;
+            case OP_OR:  a = a || b; break;
+            default: break;
+            }
+        }
+        return static_cast<uint32_t>(stack[0]);
+    }
+
+    constexpr bool AMLStringPluralRule::sameCode(const AMLStringPluralRule& other) const noexcept
+    {
+        if (_M_length != other._M_length)
+            return false;
+        for (size_t i = 0; i < _M_length; ++i) {
+            if (_M_code[i] != other._M_code[i])
+                return false;
+        }
+        return true;
+    }
+
+    constexpr bool AMLStringPluralRule::parse(const char* expression, uint8_t nplurals) noexcept
+    {
+        AMLStringPluralRule rule;
+        if (nplurals == 0 || !_T_AM_StringPluralParser(expression, rule).parse())
+            return false;
+        rule._M_nplurals = nplurals;
+        rule._M_family = BYTECODE;
+
+        // bytecode does not depend on spaces and parentheses, so equal code means equal rule
+        struct Known
+        {
+            Family      family;
+            const char* expression;
+        };
+        constexpr Known known[] = {
+            {GERMANIC,    "n != 1"},
+            {ONE_FORM,    "0"},
+            {FRENCH,      "n > 1"},
+            {CZECH,       "n == 1 ? 0 : n >= 2 && n <= 4 ? 1 : 2"},
+            {EAST_SLAVIC, "n % 10 == 1 && n % 100 != 11 ? 0 : n % 10 >= 2 && n % 10 <= 4 && (n % 100 < 10 || n % 100 >= 20) ? 1 : 2"},
+            {POLISH,      "n == 1 ? 0 : n % 10 >= 2 && n % 10 <= 4 && (n % 100 < 10 || n % 100 >= 20) ? 1 : 2"},
+        };
+        for (const Known& k : known) {
+            AMLStringPluralRule candidate;
+            _T_AM_StringPluralParser(k.expression, candidate).parse();
+            if (rule.sameCode(candidate)) {
+                rule._M_family = k.family;
+                break;
+            }
+        }
+        *this = rule;
+        return true;
+    }
+
+    constexpr bool AMLStringPluralRule::parseHeader(const char* header) noexcept
+    {
+        auto find = [](const char* text, const char* token) constexpr -> const char* {
+            for (; *text != '\0'; ++text) {
+                size_t i = 0;
+                while (token[i] != '\0' && text[i] == token[i])
+                    ++i;
+                if (token[i] == '\0')
+                    return text + i;
+            }
+            return nullptr;
+        };
+        if (!header)
+            return false;
+        const char* line = find(header, "Plural-Forms:");
+        if (!line)
+            return false;
+        const char* count = find(line, "nplurals=");
+        const char* expression = find(line, "plural=");
+        if (!count || !expression)
+            return false;
+        unsigned nplurals = 0;
+        for (; *count >= '0' && *count <= '9'; ++count)
+            nplurals = nplurals * 10 + (*count - '0');
+        if (nplurals == 0 || nplurals > 255)
+            return false;
+        return parse(expression, static_cast<uint8_t>(nplurals));
+    }
+
+}//namespace
+
+/** @} */
+
+#endif /* AMLSTRINGPLURAL_H */
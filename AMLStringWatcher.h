@@ -0,0 +1,117 @@
+/*!
+*   @file AMLStringWatcher.h
+*   This file is interface for reloading of <b>.mo</b> files changed while program runs.
+*
+*   @author Zdeněk Skulínek  &lt;<a href="mailto:zdenek.skulinek@seznam.cz">me@zdenekskulinek.cz</a>&gt;
+*/
+#ifndef AMLSTRINGWATCHER_H
+#define AMLSTRINGWATCHER_H
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "AMLString.h"
+
+/**
+ *  @ingroup Strings
+ *  @{
+ */
+
+namespace AMCore {
+
+    /**
+     *  @ingroup Strings
+     *  @brief Reloads languages when their <b>.mo</b> files change (Linux inotify).
+     *
+     *  Changed file is compared with the previous one and only entries which differ are looked up in
+     *  the table, other translations are copied from the previous language. Every reload still creates
+     *  language with views of the whole table, it saves binding, not copying. The new language is
+     *  published the same way as by AMLStringLanguage::activate() or publish() and the previous one
+     *  is retired, so readers never block and always see one whole language. Retired languages are
+     *  deleted by AMLStringLanguage::reclaim() called by program, watcher does not know its readers.
+     *  Catalogs of the previous language stay mapped as long as translations point into them.
+     *
+     *  Files must be replaced by rename (as rsync, package managers and editors do). Catalog rewritten
+     *  in place may be read while it is incomplete.
+     */
+    class AMLStringWatcher
+    {
+        struct Watch;
+
+        int                     _M_inotify;
+        int                     _M_wake;            // eventfd stopping background thread
+        std::thread             _M_thread;
+        std::atomic<bool>       _M_running;
+        std::mutex              _M_mutex;           // guards watches
+        std::vector<Watch*>     _M_watches;
+        std::atomic<size_t>     _M_reloads;
+
+        int add(int languageId, const char* name, const char* table);
+        bool reload(Watch& watch);
+        static void publish(const Watch& watch, _T_AM_StringList* list, AMLStringLanguage* language);
+        void run();
+    public:
+        AMLStringWatcher();
+
+        /**
+         * @brief Stops background thread. Languages stay published.
+         */
+        ~AMLStringWatcher();
+        AMLStringWatcher(const AMLStringWatcher&) = delete;
+        AMLStringWatcher& operator=(const AMLStringWatcher&) = delete;
+
+        /**
+         * @brief Loads <b>.mo</b> file into new language, activates it for all threads and reloads it
+         *        whenever the file changes. Catalog of a named domain is bound to its table instead
+         *        (see _T_AM_StringList::Load()), so the active language is kept. Such a table must not
+         *        be loaded by program while it is watched.
+         * @param name file name
+         * @param table string table name
+         * @return number of translated items or -1 if file or table cannot be found or watched
+         */
+        int watch(const char* name, const char* table = "default");
+
+        /**
+         * @brief Loads <b>.mo</b> file into new language, publishes it into slot and reloads it whenever
+         *        the file changes.
+         * @param languageId slot of language
+         * @param name file name
+         * @param table string table name
+         * @return number of translated items or -1 if file or table cannot be found or watched
+         */
+        int watch(AMLStringLanguageId languageId, const char* name, const char* table = "default");
+
+        /**
+         * @brief Reloads files changed since last call. Called by background thread, or by program
+         *        which has its own event loop.
+         * @param timeout milliseconds to wait for a change, 0 to return immediately
+         * @return number of reloaded languages
+         */
+        size_t poll(int timeout);
+
+        /**
+         * @brief Starts background thread calling poll().
+         * @return false if thread is running already
+         */
+        bool start();
+
+        /**
+         * @brief Stops background thread, files changed later are not reloaded until start().
+         */
+        void stop();
+
+        /**
+         * @return number of reloads since watcher was created
+         */
+        size_t reloads() const noexcept
+        {
+            return _M_reloads.load(std::memory_order_relaxed);
+        }
+    };
+
+}//namespace
+
+/** @} */
+
+#endif /* AMLSTRINGWATCHER_H */
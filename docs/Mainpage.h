@@ -7,7 +7,11 @@
 
  * Usage is as usual with gettext. Parser finds all occurences of function "_" an store it to file with **po** suffix.
  * This file is merged into global a take to translator. Result of this is process is **mo** file, that can be included
- * back into project. Loading of **mo** files is not accomplished at this time.
+ * back into project. The **mo** file is mapped into memory and translations point directly into it:
+ *
+ * \code
+ * _T_AM_StringList::GetStringTable("default")->Load("cs.mo");
+ * \endcode
  *
  * How it works
  * ============
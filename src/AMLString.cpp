@@ -1,15 +1,115 @@
 #include <iostream>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #include "../AMLString.h"
+#include "../AMLStringCatalog.h"
 
 namespace AMCore {
 
 _T_AM_StringList* _T_AM_StringList::_M_root = nullptr;
+std::atomic<_T_AM_StringSectionRange*> _T_AM_StringList::_M_pending_sections(nullptr);
+uint32_t _T_AM_StringList::_M_item_count = 0;
+std::atomic<_T_AM_StringItemSlot* const*> _T_AM_StringList::_M_slot_index(nullptr);
+std::atomic<_T_AM_StringTranslation*> _T_AM_StringList::_M_translation_index(nullptr);
+std::atomic<uint32_t> _T_AM_StringList::_M_slot_index_count(0);
+
+// guards item lists, registration may run from static initializers of dlopen-ed libraries
+static std::mutex g_registration_mutex;
+// guards switching of table bindings and translations set to single items, taken after the one above
+static std::mutex g_binding_mutex;
+
+/*
+ *  Snapshot of all tables sorted by name hash. Tables merged by Add() are stored next to each other,
+ *  every table refers to its range of chunks. Perfect hash of distinct name hashes gives the first
+ *  table with hash. Snapshots are immutable, outdated ones are kept because readers may still use
+ *  them (there are only a few tables).
+ */
+struct _T_AM_StringDirectory
+{
+    uint32_t                       _M_version;
+    std::vector<uint64_t>          _M_hashes;
+    std::vector<_T_AM_StringList*> _M_lists;
+    std::vector<uint32_t>          _M_chunk_begin;     // chunks of table i are [begin[i], begin[i + 1])
+    std::vector<_T_AM_StringList*> _M_chunks;
+    std::vector<uint32_t>          _M_displacements;
+    std::vector<uint32_t>          _M_slots;
+    AMLStringPerfectHash           _M_perfect_hash;
+    const _T_AM_StringDirectory*   _M_previous;
+
+    /*
+     *  Index of the first table with hash, size of _M_hashes if there is none
+     */
+    uint32_t first(uint64_t hash) const noexcept
+    {
+        const uint32_t count = static_cast<uint32_t>(_M_hashes.size());
+        if (_M_perfect_hash.size()) {
+            const uint32_t i = _M_slots[_M_perfect_hash(hash)];
+            return _M_hashes[i] == hash ? i : count;
+        }
+        auto it = std::lower_bound(_M_hashes.begin(), _M_hashes.end(), hash);
+        return (it != _M_hashes.end() && *it == hash) ? static_cast<uint32_t>(it - _M_hashes.begin()) : count;
+    }
+};
+
+/*
+ *  Index of items of one table for lookup by original string known at runtime. Items are sorted by
+ *  hash, perfect hash of distinct hashes gives the first item with hash. Blocked Bloom filter sets
+ *  three bits of one word per item, so most misses cost one load. Index is immutable.
+ */
+struct _T_AM_StringLookup
+{
+    std::vector<_T_AM_StringItemBase*> _M_items;
+    std::vector<uint32_t>              _M_positions;       // in _M_items of items in order of items()
+    std::vector<uint32_t>              _M_displacements;
+    std::vector<uint32_t>              _M_slots;
+    AMLStringPerfectHash               _M_perfect_hash;
+    std::vector<uint64_t>              _M_bloom;
+    const _T_AM_StringLookup*          _M_previous;
+
+    static constexpr uint32_t BLOOM_BITS_PER_ITEM = 12;
+
+    static uint64_t bloomMask(uint64_t hash) noexcept
+    {
+        return (uint64_t(1) << (hash & 63)) | (uint64_t(1) << ((hash >> 6) & 63)) |
+               (uint64_t(1) << ((hash >> 12) & 63));
+    }
+
+    uint64_t& bloomWord(uint64_t hash) noexcept
+    {
+        return _M_bloom[((hash >> 32) * _M_bloom.size()) >> 32];
+    }
+
+    const uint64_t& bloomWord(uint64_t hash) const noexcept
+    {
+        return _M_bloom[((hash >> 32) * _M_bloom.size()) >> 32];
+    }
+};
+
+/*
+ *  Items of one table sorted by original string. Order is built by finalize() and published as
+ *  a whole, outdated ones are kept because other threads may still walk them.
+ */
+struct _T_AM_StringOrder
+{
+    std::vector<_T_AM_StringItemBase*> _M_items;
+    const _T_AM_StringOrder*           _M_previous;
+};
+
+static std::atomic<const _T_AM_StringDirectory*> g_directory(nullptr);
+// incremented whenever table is created or merged
+static std::atomic<uint32_t> g_directory_version(1);
 
 _T_AM_StringList::_T_AM_StringList(const uint64_t tableHash) :
     _M_name_hash(tableHash)
 {
+    std::lock_guard<std::mutex> lock(g_registration_mutex);
     if (!_M_root) {
         _M_root=this;
         _M_next=0;
@@ -25,20 +125,80 @@ _T_AM_StringList::_T_AM_StringList(const uint64_t tableHash) :
         _M_next = pp;
     }
     _M_next_chunk = this;
+    g_directory_version.fetch_add(1, std::memory_order_release);
 }
 
 _T_AM_StringList::~_T_AM_StringList() {}
 
+/*
+ *  Returns current directory, rebuilds it if any table was created or merged since it was built
+ */
+const _T_AM_StringDirectory* _T_AM_StringList::directory()
+{
+    const _T_AM_StringDirectory* dir = g_directory.load(std::memory_order_acquire);
+    if (dir && dir->_M_version == g_directory_version.load(std::memory_order_acquire))
+        return dir;
+    std::lock_guard<std::mutex> lock(g_registration_mutex);
+    dir = g_directory.load(std::memory_order_relaxed);
+    const uint32_t version = g_directory_version.load(std::memory_order_relaxed);
+    if (dir && dir->_M_version == version)
+        return dir;
+
+    _T_AM_StringDirectory* built = new _T_AM_StringDirectory();
+    built->_M_version = version;
+    built->_M_previous = dir;
+    // tables are linked sorted by name hash
+    for (_T_AM_StringList* list = _M_root; list; list = list->_M_next) {
+        built->_M_hashes.push_back(list->_M_name_hash);
+        built->_M_lists.push_back(list);
+        built->_M_chunk_begin.push_back(static_cast<uint32_t>(built->_M_chunks.size()));
+        _T_AM_StringList* chunk = list;
+        do {
+            built->_M_chunks.push_back(chunk);
+            chunk = chunk->_M_next_chunk;
+        } while (chunk != list);
+    }
+    built->_M_chunk_begin.push_back(static_cast<uint32_t>(built->_M_chunks.size()));
+    std::vector<uint64_t> hashes;
+    std::vector<uint32_t> first;
+    for (size_t i = 0; i < built->_M_hashes.size(); ++i) {
+        if (i == 0 || built->_M_hashes[i] != hashes.back()) {
+            hashes.push_back(built->_M_hashes[i]);
+            first.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    const uint32_t count = static_cast<uint32_t>(hashes.size());
+    if (count && AMLStringPerfectHash::build(hashes.data(), count, built->_M_displacements)) {
+        built->_M_perfect_hash = AMLStringPerfectHash(built->_M_displacements.data(),
+                                                      static_cast<uint32_t>(built->_M_displacements.size()), count);
+        built->_M_slots.resize(count);
+        for (uint32_t i = 0; i < count; ++i)
+            built->_M_slots[built->_M_perfect_hash(hashes[i])] = first[i];
+    }
+    g_directory.store(built, std::memory_order_release);
+    return built;
+}
+
 _T_AM_StringList* _T_AM_StringList::GetStringTable(const uint64_t nameHash)
 {
-    _T_AM_StringList* pp = _M_root;
-    while (pp)
-    {
-        if (pp->_M_name_hash == nameHash)
-            return pp;
-        pp = pp->_M_next;
+    const _T_AM_StringDirectory* dir = directory();
+    const uint32_t i = dir->first(nameHash);
+    if (i == dir->_M_hashes.size())
+        return nullptr;
+    _T_AM_StringList* list = dir->_M_lists[i];
+    list->finalize();
+    return list;
+}
+
+_T_AM_StringListRange _T_AM_StringList::chunks() const
+{
+    const _T_AM_StringDirectory* dir = directory();
+    // several tables may have the same hash
+    for (size_t i = dir->first(_M_name_hash); i < dir->_M_lists.size() && dir->_M_hashes[i] == _M_name_hash; ++i) {
+        if (dir->_M_lists[i] == this)
+            return {&dir->_M_chunks[dir->_M_chunk_begin[i]], &dir->_M_chunks[0] + dir->_M_chunk_begin[i + 1]};
     }
-    return nullptr;
+    return {nullptr, nullptr};
 }
 
 _T_AM_StringList* _T_AM_StringList::GetStringTable(const char* name)
@@ -50,6 +210,7 @@ void _T_AM_StringList::Add(_T_AM_StringList& second)
 {
     if (&second == this)
         return;
+    std::lock_guard<std::mutex> lock(g_registration_mutex);
     _T_AM_StringList* pp = this;
     while (pp->_M_next_chunk != this)
     {
@@ -59,37 +220,717 @@ void _T_AM_StringList::Add(_T_AM_StringList& second)
     }
     pp->_M_next_chunk = &second;
     second._M_next_chunk = this;
+    g_directory_version.fetch_add(1, std::memory_order_release);
+}
+
+/*
+ *  Items of all tables share one ordinal space, ordinal UNREGISTERED marks item not registered yet.
+ *  Registration beyond the limit aborts, ordinal of every string must index views of languages.
+ */
+static const uint32_t MAX_ITEMS = _T_AM_StringItemBase::UNREGISTERED;
+
+/*
+ *  Slots and links of items created at runtime, deques never move them. Slots are kept apart from
+ *  links, so that they share cache lines. Items may be registered from static initializers of other
+ *  modules, so both are created on first use.
+ */
+static std::deque<_T_AM_StringItemSlot>& runtimeSlots()
+{
+    static std::deque<_T_AM_StringItemSlot> slots;
+    return slots;
+}
+
+static std::deque<_T_AM_StringLink>& runtimeLinks()
+{
+    static std::deque<_T_AM_StringLink> links;
+    return links;
+}
+
+/*
+ *  Links are atomic, but finalize() relinks sorted items, so only walks under registration mutex see
+ *  one consistent order. Other threads walk order snapshots of _T_AM_StringList::items().
+ */
+static void setNextItem(_T_AM_StringItemBase* item, _T_AM_StringItemBase* next)
+{
+    item->_M_link->store(next, std::memory_order_release);
 }
 
+void _T_AM_StringList::appendItem(_T_AM_StringItemBase* item)
+{
+    if (_M_item_count == MAX_ITEMS) {
+        fprintf(stderr, "AMLString: more than %u strings registered\n", MAX_ITEMS);
+        abort();
+    }
+    if (!item->_M_slot) {
+        item->_M_slot = &runtimeSlots().emplace_back(item);
+        item->_M_link = &runtimeLinks().emplace_back(nullptr);
+    }
+    item->_M_slot->_M_ordinal = _M_item_count++;
+    setNextItem(item, nullptr);
+    if (_M_last_item)
+        setNextItem(_M_last_item, item);
+    else
+        _M_first_item = item;
+    _M_last_item = item;
+    _M_unsorted.store(true, std::memory_order_release);
+}
 
 _T_AM_StringList& _T_AM_StringList::registerItem(_T_AM_StringItemBase* item)
 {
-    _T_AM_StringItemBase* p = _M_first_item;
-    _T_AM_StringItemBase* pLast = nullptr;
-    while( p ) {
-        if (strcmp(item->_M_original_str, p->_M_original_str) < 0) {
-            if (pLast) {
-                item->_M_next = pLast->_M_next;
-                pLast->_M_next = item;
-            }
-            else {
-                item->_M_next = _M_first_item;
-                _M_first_item = item;
-            }
-            return *this;
+    std::lock_guard<std::mutex> lock(g_registration_mutex);
+    appendItem(item);
+    return *this;
+}
+
+void _T_AM_StringList::registerSection(_T_AM_StringSectionRange* range)
+{
+    std::lock_guard<std::mutex> lock(g_registration_mutex);
+    range->_M_next = _M_pending_sections.load(std::memory_order_relaxed);
+    _M_pending_sections.store(range, std::memory_order_release);
+}
+
+void _T_AM_StringList::scanSections()
+{
+    while (const _T_AM_StringSectionRange* range = _M_pending_sections.load(std::memory_order_relaxed)) {
+        _M_pending_sections.store(range->_M_next, std::memory_order_relaxed);
+        for (const _T_AM_StringSectionEntry* entry = range->_M_begin; entry < range->_M_end; ++entry) {
+            _T_AM_StringItemBase* item = entry->_M_item;
+            _T_AM_StringList* list = entry->_M_list;
+            // the same item may be listed in sections of several modules
+            if (item->getOrdinal() != _T_AM_StringItemBase::UNREGISTERED)
+                continue;
+            list->appendItem(item);
         }
-        pLast = p;
-        p = p->_M_next;
     }
-    if (pLast) {
-        pLast->_M_next = item;
-        item->_M_next = nullptr;
+}
+
+/*
+ *  Sorted order is built aside and published by one store, threads walking the previous order are
+ *  not disturbed. Called under registration mutex.
+ */
+void _T_AM_StringList::sortItems()
+{
+    if (!_M_unsorted.load(std::memory_order_relaxed))
+        return;
+    _T_AM_StringOrder* order = new _T_AM_StringOrder();
+    for (_T_AM_StringItemBase* p = _M_first_item; p; p = p->getNextItem())
+        order->_M_items.push_back(p);
+    std::vector<_T_AM_StringItemBase*>& items = order->_M_items;
+    std::stable_sort(items.begin(), items.end(),
+        [](const _T_AM_StringItemBase* a, const _T_AM_StringItemBase* b) {
+            return strcmp(a->_M_original_str, b->_M_original_str) < 0;
+        });
+    for (size_t i = 1; i < items.size(); ++i)
+        setNextItem(items[i - 1], items[i]);
+    setNextItem(items.back(), nullptr);
+    _M_first_item = items.front();
+    _M_last_item = items.back();
+    order->_M_previous = _M_orders;
+    _M_orders = order;
+    _M_order.store(order, std::memory_order_release);
+    // lookup index is built again by the next find()
+    _M_lookup.store(nullptr, std::memory_order_release);
+    _M_unsorted.store(false, std::memory_order_release);
+}
+
+void _T_AM_StringList::finalize()
+{
+    // tables are resolved per request, finalized table must not cost a lock
+    if (!_M_unsorted.load(std::memory_order_acquire) && !_M_pending_sections.load(std::memory_order_acquire))
+        return;
+    std::lock_guard<std::mutex> lock(g_registration_mutex);
+    scanSections();
+    sortItems();
+}
+
+/*
+ *  All tables are sorted under one lock, every counted item is in an order snapshot
+ */
+uint32_t _T_AM_StringList::finalizeAll()
+{
+    std::lock_guard<std::mutex> lock(g_registration_mutex);
+    scanSections();
+    for (_T_AM_StringList* pp = _M_root; pp; pp = pp->_M_next)
+        pp->sortItems();
+    indexSlots();
+    return _M_item_count;
+}
+
+_T_AM_StringItemRange _T_AM_StringList::items()
+{
+    finalize();
+    const _T_AM_StringOrder* order = _M_order.load(std::memory_order_acquire);
+    if (!order)
+        return {nullptr, nullptr};
+    return {order->_M_items.data(), order->_M_items.data() + order->_M_items.size()};
+}
+
+/*
+ *  Slot and translation of every ordinal, used by AMLStringHandle and by strings the active language
+ *  does not translate. Indexes are rebuilt only if items were registered since they were built,
+ *  outdated ones are kept because readers may still use them. Translations are copied under binding
+ *  mutex, none set meanwhile is lost.
+ */
+void _T_AM_StringList::indexSlots()
+{
+    const uint32_t count = _M_item_count;
+    const uint32_t indexed = _M_slot_index_count.load(std::memory_order_relaxed);
+    if (count == indexed)
+        return;
+    _T_AM_StringItemSlot** slots = new _T_AM_StringItemSlot*[count]();
+    for (_T_AM_StringList* list = _M_root; list; list = list->_M_next) {
+        for (_T_AM_StringItemBase* p = list->_M_first_item; p; p = p->getNextItem())
+            slots[p->_M_slot->_M_ordinal] = p->_M_slot;
     }
-    else {
-        _M_first_item = item;
-        item->_M_next = nullptr;
+    _T_AM_StringTranslation* translations = new _T_AM_StringTranslation[count]();
+    std::lock_guard<std::mutex> lock(g_binding_mutex);
+    const _T_AM_StringTranslation* previous = _M_translation_index.load(std::memory_order_relaxed);
+    for (uint32_t i = 0; i < count; ++i) {
+        const _T_AM_StringItemBase* item = slots[i]->_M_item;
+        const std::string_view v = i < indexed ? previous[i].view()
+                                               : std::string_view(item->getSourceString(), item->getSourceLength());
+        translations[i].store(v.data(), static_cast<uint32_t>(v.size()));
     }
-    return *this;
-};
+    // the count is published last, indexes read after it cover all counted items
+    _M_slot_index.store(slots, std::memory_order_release);
+    _M_translation_index.store(translations, std::memory_order_release);
+    _M_slot_index_count.store(count, std::memory_order_release);
+}
+
+/*
+ *  Called under binding mutex, nullptr restores item string
+ */
+void _T_AM_StringList::storeTranslation(uint32_t ordinal, const _T_AM_StringView* translation) noexcept
+{
+    _T_AM_StringTranslation& entry = _M_translation_index.load(std::memory_order_relaxed)[ordinal];
+    if (translation) {
+        entry.store(translation->_M_str, translation->_M_length);
+    } else {
+        const _T_AM_StringItemBase* item = _M_slot_index.load(std::memory_order_relaxed)[ordinal]->_M_item;
+        entry.store(item->getSourceString(), static_cast<uint32_t>(item->getSourceLength()));
+    }
+}
+
+const _T_AM_StringLookup* _T_AM_StringList::buildLookup()
+{
+    std::lock_guard<std::mutex> lock(g_registration_mutex);
+    const _T_AM_StringLookup* current = _M_lookup.load(std::memory_order_acquire);
+    if (current)
+        return current;
+    _T_AM_StringLookup* lookup = new _T_AM_StringLookup();
+    std::vector<uint32_t> sorted;
+    if (const _T_AM_StringOrder* order = _M_order.load(std::memory_order_relaxed)) {
+        for (uint32_t i = 0; i < order->_M_items.size(); ++i)
+            sorted.push_back(i);
+        std::stable_sort(sorted.begin(), sorted.end(), [order](uint32_t a, uint32_t b) {
+            return order->_M_items[a]->_M_hash < order->_M_items[b]->_M_hash;
+        });
+        lookup->_M_positions.resize(sorted.size());
+        for (uint32_t i = 0; i < sorted.size(); ++i) {
+            lookup->_M_items.push_back(order->_M_items[sorted[i]]);
+            lookup->_M_positions[sorted[i]] = i;
+        }
+    }
+    // singular and plural of one msgid share hash, they are told apart by strings
+    std::vector<uint64_t> hashes;
+    std::vector<uint32_t> first;
+    for (size_t i = 0; i < lookup->_M_items.size(); ++i) {
+        const uint64_t hash = lookup->_M_items[i]->_M_hash;
+        if (i == 0 || hash != hashes.back()) {
+            hashes.push_back(hash);
+            first.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    const uint32_t count = static_cast<uint32_t>(hashes.size());
+    // table without perfect hash is searched by binary search of hashes
+    if (AMLStringPerfectHash::build(hashes.data(), count, lookup->_M_displacements)) {
+        lookup->_M_perfect_hash = AMLStringPerfectHash(lookup->_M_displacements.data(),
+                                                       static_cast<uint32_t>(lookup->_M_displacements.size()), count);
+        lookup->_M_slots.resize(count);
+        for (uint32_t i = 0; i < count; ++i)
+            lookup->_M_slots[lookup->_M_perfect_hash(hashes[i])] = first[i];
+    }
+    lookup->_M_bloom.assign(count * _T_AM_StringLookup::BLOOM_BITS_PER_ITEM / 64 + 1, 0);
+    for (uint64_t hash : hashes)
+        lookup->bloomWord(hash) |= _T_AM_StringLookup::bloomMask(hash);
+    lookup->_M_previous = _M_lookups;
+    _M_lookups = lookup;
+    _M_lookup.store(lookup, std::memory_order_release);
+    return lookup;
+}
+
+/*
+ *  Index of the first item with original in lookup items, items.size() if there is none. Singular
+ *  and plural items of one msgid follow it.
+ */
+static uint32_t findFirst(const _T_AM_StringLookup* lookup, std::string_view original) noexcept
+{
+    const std::vector<_T_AM_StringItemBase*>& items = lookup->_M_items;
+    const uint64_t hash = _T_AM_StringItemBase::ceHash(original);
+    const uint64_t mask = _T_AM_StringLookup::bloomMask(hash);
+    if ((lookup->bloomWord(hash) & mask) != mask)
+        return static_cast<uint32_t>(items.size());
+    uint32_t i;
+    if (lookup->_M_perfect_hash.size())
+        i = lookup->_M_slots[lookup->_M_perfect_hash(hash)];
+    else
+        i = static_cast<uint32_t>(std::lower_bound(items.begin(), items.end(), hash,
+            [](const _T_AM_StringItemBase* p, uint64_t h) { return p->_M_hash < h; }) - items.begin());
+    for (; i < items.size() && items[i]->_M_hash == hash; ++i) {
+        if (std::string_view(items[i]->_M_original_str) == original)
+            return i;
+    }
+    return static_cast<uint32_t>(items.size());
+}
+
+/*
+ *  Index of finalized table, built by the first lookup after items were registered
+ */
+const _T_AM_StringLookup* _T_AM_StringList::lookup()
+{
+    finalize();
+    const _T_AM_StringLookup* current = _M_lookup.load(std::memory_order_acquire);
+    return current ? current : buildLookup();
+}
+
+const _T_AM_StringItemBase* _T_AM_StringList::find(std::string_view original)
+{
+    const _T_AM_StringLookup* lookup = this->lookup();
+    const uint32_t index = findFirst(lookup, original);
+    return index < lookup->_M_items.size() ? lookup->_M_items[index] : nullptr;
+}
+
+std::vector<const _T_AM_StringItemBase*> _T_AM_StringList::findAll(std::string_view msgid)
+{
+    const _T_AM_StringLookup* lookup = this->lookup();
+    // items are hashed and compared up to the end of singular, as bind() compares them
+    const std::string_view singular = msgid.substr(0, msgid.find('\0'));
+    std::vector<const _T_AM_StringItemBase*> found;
+    const std::vector<_T_AM_StringItemBase*>& items = lookup->_M_items;
+    const uint32_t first = findFirst(lookup, singular);
+    for (uint32_t i = first; i < items.size() && items[i]->_M_hash == items[first]->_M_hash; ++i) {
+        if (std::string_view(items[i]->_M_original_str) == singular)
+            found.push_back(items[i]);
+    }
+    return found;
+}
+
+AMLString _T_AM_StringList::find(std::string_view original, const AMLString& fallback)
+{
+    const _T_AM_StringItemBase* item = find(original);
+    return item ? item->getAMLString() : fallback;
+}
+
+#ifdef AMLSTRING_FIXED_LANGUAGE
+void AMLString::resolve(const AMLString* strings, size_t count, std::string_view* views) noexcept
+{
+    // translations are constants, there is nothing to wait for
+    for (size_t i = 0; i < count; ++i)
+        views[i] = strings[i].view();
+}
+#else
+// strings prefetched ahead of the resolved one, AMLString is prefetched in two stages: slot, then view
+static const size_t RESOLVE_DISTANCE = 8;
+
+/*
+ *  Translation of one string in batch, overlay and language are selected once for all strings.
+ *  Slot of handle is looked up only if neither of them holds the string.
+ */
+static inline std::string_view resolveOrdinal(uint32_t ordinal, const _T_AM_StringItemSlot* slot,
+                                              const AMLStringOverlay* overlay, const AMLStringLanguage* language)
+{
+    const _T_AM_StringView* v = overlay ? overlay->find(ordinal) : nullptr;
+    if (!v && language)
+        v = language->find(ordinal);
+    if (v)
+        return std::string_view(v->_M_str, v->_M_length);
+    if (slot)
+        return slot->getItemView();
+    return _T_AM_StringList::translation(ordinal).view();
+}
+
+static inline const AMLStringLanguage* resolveLanguage(const AMLStringOverlay* overlay)
+{
+    if (overlay && overlay->language())
+        return overlay->language();
+    return AMLStringLanguage::active();
+}
+
+void AMLString::resolve(const AMLString* strings, size_t count, std::string_view* views) noexcept
+{
+    const AMLStringOverlay* overlay = AMLStringOverlay::active();
+    const AMLStringLanguage* language = resolveLanguage(overlay);
+    for (size_t i = 0; i < count; ++i) {
+        if (i + 2 * RESOLVE_DISTANCE < count)
+            __builtin_prefetch(strings[i + 2 * RESOLVE_DISTANCE]._M_provider._M_slot);
+        if (language && i + RESOLVE_DISTANCE < count)
+            __builtin_prefetch(language->find(strings[i + RESOLVE_DISTANCE]._M_provider._M_slot->_M_ordinal));
+        const _T_AM_StringItemSlot* slot = strings[i]._M_provider._M_slot;
+        views[i] = resolveOrdinal(slot->_M_ordinal, slot, overlay, language);
+    }
+}
+
+void AMLStringHandle::resolve(const AMLStringHandle* handles, size_t count, std::string_view* views) noexcept
+{
+    const AMLStringOverlay* overlay = AMLStringOverlay::active();
+    const AMLStringLanguage* language = resolveLanguage(overlay);
+    for (size_t i = 0; i < count; ++i) {
+        // ordinal is at hand, only view (or translation of item the language does not hold) is waited for
+        if (i + RESOLVE_DISTANCE < count) {
+            const uint32_t ordinal = handles[i + RESOLVE_DISTANCE]._M_provider._M_ordinal;
+            const _T_AM_StringView* v = language ? language->find(ordinal) : nullptr;
+            __builtin_prefetch(v ? v : static_cast<const void*>(&_T_AM_StringList::translation(ordinal)));
+        }
+        views[i] = resolveOrdinal(handles[i]._M_provider._M_ordinal, nullptr, overlay, language);
+    }
+}
+
+AMLStringHandle::AMLStringHandle(const AMLString& string) :
+    AMLStringHandleBase(AMLStringHandleProvider(string.item()->getOrdinal()))
+{
+    // items of linker sections get ordinals when their table is finalized
+    if (_M_provider._M_ordinal >= _T_AM_StringList::indexedCount()) {
+        _T_AM_StringList::finalizeAll();
+        _M_provider._M_ordinal = string.item()->getOrdinal();
+    }
+}
+#endif
+
+#ifndef AMLSTRING_FIXED_LANGUAGE
+void _T_AM_StringItemSlot::setTranslatedString(const char* str, size_t length)
+{
+    // item registered since the last index gets its entry first
+    if (_M_ordinal >= _T_AM_StringList::indexedCount())
+        _T_AM_StringList::finalizeAll();
+    std::lock_guard<std::mutex> lock(g_binding_mutex);
+    if (_M_ordinal >= _T_AM_StringList::indexedCount())
+        return;
+    const _T_AM_StringView translation = {str, static_cast<uint32_t>(length)};
+    _T_AM_StringList::storeTranslation(_M_ordinal, &translation);
+}
+
+void _T_AM_StringItemSlot::resetTranslatedString() noexcept
+{
+    std::lock_guard<std::mutex> lock(g_binding_mutex);
+    if (_M_ordinal < _T_AM_StringList::indexedCount())
+        _T_AM_StringList::storeTranslation(_M_ordinal, nullptr);
+}
+#endif
+
+const AMLStringPluralRule& _T_AM_StringList::pluralRule() const noexcept
+{
+    static const AMLStringPluralRule unbound;
+    const AMLStringLanguage* language = binding();
+    return language ? language->pluralRule() : unbound;
+}
+
+/*
+ *  Translations of items bound by language point into its views, other items get their source back.
+ *  Replaced binding is retired, readers may still hold its translations.
+ */
+void _T_AM_StringList::publishBinding(AMLStringLanguage* binding)
+{
+#ifndef AMLSTRING_FIXED_LANGUAGE
+    // every item of table is indexed before binding mutex is taken
+    finalizeAll();
+    const _T_AM_StringItemRange range = items();
+    std::lock_guard<std::mutex> lock(g_binding_mutex);
+    const uint32_t indexed = indexedCount();
+    for (_T_AM_StringItemBase* p : range) {
+        // items registered meanwhile are not bound yet
+        const uint32_t ordinal = p->getOrdinal();
+        if (ordinal < indexed)
+            storeTranslation(ordinal, binding ? binding->find(ordinal) : nullptr);
+    }
+#else
+    std::lock_guard<std::mutex> lock(g_binding_mutex);
+#endif
+    AMLStringLanguage* previous = _M_binding.exchange(binding, std::memory_order_acq_rel);
+    if (previous)
+        AMLStringLanguage::retire(previous);
+}
+
+AMLStringBindReport _T_AM_StringList::bind(const AMLStringCatalog& catalog)
+{
+    AMLStringLanguage* binding = new AMLStringLanguage(this);
+    const AMLStringBindReport report = binding->bind(*this, catalog);
+    publishBinding(binding);
+    return report;
+}
+
+AMLStringBindReport _T_AM_StringList::bind(const AMLStringCompiledCatalog& catalog)
+{
+    AMLStringLanguage* binding = new AMLStringLanguage(this);
+    const AMLStringBindReport report = binding->bind(*this, catalog);
+    publishBinding(binding);
+    return report;
+}
+
+/*
+ *  Sets translation to language view. Items registered after language was created do not have views.
+ */
+static void translateItem(_T_AM_StringItemBase* p, const char* str, size_t length,
+                          _T_AM_StringView* views, uint32_t viewBase, uint32_t viewCount)
+{
+    const uint32_t index = p->getOrdinal() - viewBase;
+    if (index < viewCount)
+        views[index] = {str, static_cast<uint32_t>(length)};
+}
+
+/*
+ *  Compiled catalog is sorted by hash, item is looked up by binary search of its hash and strings
+ *  are compared only when hashes are equal. Returns count() if item has no entry.
+ */
+static uint32_t findEntry(const AMLStringCompiledCatalog& catalog, const _T_AM_StringItemBase* p)
+{
+    const uint64_t hash = p->_M_hash;
+    for (uint32_t index = catalog.find(hash); index < catalog.count() && catalog.entry(index)._M_hash == hash; ++index) {
+        // plural original "a\0b" matches item "a" as well
+        if (strcmp(p->_M_original_str, catalog.getOriginalString(catalog.entry(index))) == 0)
+            return index;
+    }
+    return catalog.count();
+}
+
+/*
+ *  Plural item takes all forms, singular item only the first one
+ */
+static _T_AM_StringView entryTranslation(const AMLStringCompiledCatalog& catalog, uint32_t index,
+                                         const _T_AM_StringItemBase* p)
+{
+    const AMLStringCompiledEntry& entry = catalog.entry(index);
+    const char* str = catalog.getTranslatedString(entry);
+    if (entry._M_original_length != p->getOriginalLength())
+        return {str, static_cast<uint32_t>(strlen(str))};
+    return {str, entry._M_translation_length};
+}
+
+AMLStringBindReport _T_AM_StringList::bindItems(const AMLStringCompiledCatalog& catalog, _T_AM_StringView* views,
+                                                uint32_t viewBase, uint32_t viewCount)
+{
+    AMLStringBindReport report = {0, 0, 0};
+    std::vector<bool> used(catalog.count(), false);
+    for (_T_AM_StringItemBase* p : items()) {
+        const uint32_t index = findEntry(catalog, p);
+        if (index < catalog.count()) {
+            const _T_AM_StringView translation = entryTranslation(catalog, index, p);
+            translateItem(p, translation._M_str, translation._M_length, views, viewBase, viewCount);
+            used[index] = true;
+            ++report.matched;
+        }
+        else {
+            translateItem(p, p->getSourceString(), p->getSourceLength(), views, viewBase, viewCount);
+            ++report.missing;
+        }
+    }
+    report.orphaned = std::count(used.begin(), used.end(), false);
+    return report;
+}
+
+static const uint32_t NO_ENTRY = ~uint32_t(0);
+
+// entries looked up by one thread, fewer cost more to start than to look up
+static const uint32_t BIND_RANGE_MIN = 4096;
+
+/*
+ *  Entry with empty msgid is the catalog header
+ */
+static uint32_t headerCount(const AMLStringCatalog& catalog)
+{
+    return (catalog.count() && catalog.getOriginalLength(0) == 0) ? 1 : 0;
+}
+
+/*
+ *  Looks msgids of entries [first, last) up among registered originals. Item whose original several
+ *  entries have (msgid "a" and plural "a\0b") takes the first one.
+ */
+static void matchRange(const _T_AM_StringLookup* lookup, const AMLStringCatalog& catalog, uint32_t first,
+                       uint32_t last, std::atomic<uint32_t>* entries)
+{
+    const std::vector<_T_AM_StringItemBase*>& items = lookup->_M_items;
+    for (uint32_t index = first; index < last; ++index) {
+        const std::string_view singular(catalog.getOriginalString(index));
+        for (uint32_t i = findFirst(lookup, singular);
+             i < items.size() && std::string_view(items[i]->_M_original_str) == singular; ++i) {
+            uint32_t current = entries[i].load(std::memory_order_relaxed);
+            while (index < current && !entries[i].compare_exchange_weak(current, index, std::memory_order_relaxed)) {}
+        }
+    }
+}
+
+/*
+ *  Entry of catalog for every item of lookup, NO_ENTRY if catalog has none. Catalog is walked once,
+ *  every msgid is looked up by perfect hash of registered originals and strings are compared only
+ *  when hashes are equal. Entries are split among threads.
+ */
+static std::vector<uint32_t> matchEntries(const _T_AM_StringLookup* lookup, const AMLStringCatalog& catalog,
+                                          unsigned threads)
+{
+    std::vector<std::atomic<uint32_t>> entries(lookup->_M_items.size());
+    for (std::atomic<uint32_t>& entry : entries)
+        entry.store(NO_ENTRY, std::memory_order_relaxed);
+    const uint32_t header = headerCount(catalog);
+    const uint32_t count = catalog.count();
+    const uint32_t rangeSize = std::max((count - header + threads - 1) / std::max(threads, 1u), BIND_RANGE_MIN);
+    std::vector<std::thread> workers;
+    for (uint32_t first = header + rangeSize; first < count; first += rangeSize) {
+        workers.emplace_back(matchRange, lookup, std::cref(catalog), first, std::min(first + rangeSize, count),
+                             entries.data());
+    }
+    matchRange(lookup, catalog, header, std::min(header + rangeSize, count), entries.data());
+    for (std::thread& worker : workers)
+        worker.join();
+    std::vector<uint32_t> matched(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i)
+        matched[i] = entries[i].load(std::memory_order_relaxed);
+    return matched;
+}
+
+static std::vector<uint32_t> matchEntries(const _T_AM_StringLookup* lookup, const AMLStringCompiledCatalog& catalog,
+                                          unsigned)
+{
+    std::vector<uint32_t> entries;
+    entries.reserve(lookup->_M_items.size());
+    for (const _T_AM_StringItemBase* p : lookup->_M_items) {
+        const uint32_t index = findEntry(catalog, p);
+        entries.push_back(index < catalog.count() ? index : NO_ENTRY);
+    }
+    return entries;
+}
+
+/*
+ *  Translation of item in entry, nullptr if entry has empty translation
+ */
+static _T_AM_StringView findTranslation(const AMLStringCatalog& catalog, uint32_t index, const _T_AM_StringItemBase* p)
+{
+    if (catalog.getTranslatedLength(index) == 0)
+        return {nullptr, 0};
+    const char* str = catalog.getTranslatedString(index);
+    // plural item takes all forms, singular item only the first one
+    if (catalog.getOriginalLength(index) != p->getOriginalLength())
+        return {str, static_cast<uint32_t>(strlen(str))};
+    return {str, static_cast<uint32_t>(catalog.getTranslatedLength(index))};
+}
+
+static _T_AM_StringView findTranslation(const AMLStringCompiledCatalog& catalog, uint32_t index,
+                                        const _T_AM_StringItemBase* p)
+{
+    return entryTranslation(catalog, index, p);
+}
+
+AMLStringBindReport _T_AM_StringList::bindItems(const AMLStringCatalog& catalog, _T_AM_StringView* views,
+                                                uint32_t viewBase, uint32_t viewCount, unsigned threads)
+{
+    const _T_AM_StringLookup* lookup = this->lookup();
+    const std::vector<uint32_t> entries = matchEntries(lookup, catalog, threads);
+    AMLStringBindReport report = {0, 0, catalog.count() - headerCount(catalog)};
+    uint32_t previous = NO_ENTRY;
+    for (uint32_t i = 0; i < entries.size(); ++i) {
+        _T_AM_StringItemBase* p = lookup->_M_items[i];
+        const uint32_t index = entries[i];
+        const _T_AM_StringView translation = index != NO_ENTRY ? findTranslation(catalog, index, p)
+                                                               : _T_AM_StringView{nullptr, 0};
+        if (translation._M_str) {
+            translateItem(p, translation._M_str, translation._M_length, views, viewBase, viewCount);
+            ++report.matched;
+        }
+        else {
+            translateItem(p, p->getSourceString(), p->getSourceLength(), views, viewBase, viewCount);
+            ++report.missing;
+        }
+        // items of one entry follow each other in lookup, entry is counted as used once
+        if (index != NO_ENTRY && index != previous)
+            --report.orphaned;
+        previous = index;
+    }
+    return report;
+}
+
+/*
+ *  Every item takes translation of the first layer having it, so gaps are filled at bind time and
+ *  reading a string never walks the chain. Entries of every layer are matched once for all items.
+ */
+template<typename Catalog>
+static AMLStringFallbackReport bindChain(const _T_AM_StringLookup* lookup, const Catalog* const* catalogs,
+                                         size_t count, _T_AM_StringView* views, uint32_t viewBase, uint32_t viewCount)
+{
+    AMLStringFallbackReport report = {0, 0, std::vector<size_t>(count, 0), {}};
+    std::vector<std::vector<uint32_t>> entries(count);
+    for (size_t i = 0; i < count; ++i) {
+        if (catalogs[i])
+            entries[i] = matchEntries(lookup, *catalogs[i], 1);
+    }
+    for (uint32_t position : lookup->_M_positions) {
+        _T_AM_StringItemBase* p = lookup->_M_items[position];
+        _T_AM_StringView translation = {p->getSourceString(), static_cast<uint32_t>(p->getSourceLength())};
+        int layer = -1;
+        for (size_t i = 0; i < count && layer < 0; ++i) {
+            if (!catalogs[i] || entries[i][position] == NO_ENTRY)
+                continue;
+            const _T_AM_StringView found = findTranslation(*catalogs[i], entries[i][position], p);
+            if (found._M_str) {
+                translation = found;
+                layer = static_cast<int>(i);
+            }
+        }
+        translateItem(p, translation._M_str, translation._M_length, views, viewBase, viewCount);
+        report.layers.push_back(layer);
+        if (layer < 0)
+            ++report.missing;
+        else {
+            ++report.matched;
+            ++report.supplied[layer];
+        }
+    }
+    return report;
+}
+
+AMLStringFallbackReport _T_AM_StringList::bindItems(const AMLStringCatalog* const* catalogs, size_t count,
+                                                    _T_AM_StringView* views, uint32_t viewBase, uint32_t viewCount)
+{
+    return bindChain(lookup(), catalogs, count, views, viewBase, viewCount);
+}
+
+AMLStringFallbackReport _T_AM_StringList::bindItems(const AMLStringCompiledCatalog* const* catalogs, size_t count,
+                                                    _T_AM_StringView* views, uint32_t viewBase, uint32_t viewCount)
+{
+    return bindChain(lookup(), catalogs, count, views, viewBase, viewCount);
+}
+
+AMLStringFallbackReport _T_AM_StringList::bind(const AMLStringCatalog* const* catalogs, size_t count)
+{
+    AMLStringLanguage* binding = new AMLStringLanguage(this);
+    AMLStringFallbackReport report = binding->bind(*this, catalogs, count);
+    publishBinding(binding);
+    return report;
+}
+
+AMLStringFallbackReport _T_AM_StringList::bind(const AMLStringCompiledCatalog* const* catalogs, size_t count)
+{
+    AMLStringLanguage* binding = new AMLStringLanguage(this);
+    AMLStringFallbackReport report = binding->bind(*this, catalogs, count);
+    publishBinding(binding);
+    return report;
+}
+
+int _T_AM_StringList::Load(const char* name)
+{
+    AMLStringCatalog* catalog = new AMLStringCatalog();
+    if (!catalog->open(name)) {
+        delete catalog;
+        return -1;
+    }
+    AMLStringLanguage* binding = new AMLStringLanguage(this);
+    // catalog is unmapped with its binding, once readers are quiescent
+    binding->_M_catalogs.push_back(catalog);
+    const AMLStringBindReport report = binding->bind(*this, *catalog);
+    publishBinding(binding);
+    return static_cast<int>(report.matched);
+}
+
+void _T_AM_StringList::Unload()
+{
+    publishBinding(nullptr);
+}
 
 }//namespace
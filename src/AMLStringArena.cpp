@@ -0,0 +1,144 @@
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "../AMLString.h"
+
+namespace AMCore {
+
+AMLStringArena::AMLStringArena(bool hugePages) noexcept :
+    _M_blocks(nullptr),
+    _M_top(nullptr),
+    _M_left(0),
+    _M_size(0),
+    _M_capacity(0),
+    _M_huge_pages(hugePages),
+    _M_index(nullptr),
+    _M_index_size(0),
+    _M_index_count(0)
+{}
+
+AMLStringArena::~AMLStringArena()
+{
+    release();
+}
+
+/*
+ *  Maps new block with at least size free bytes, rest of the current block is left unused
+ */
+bool AMLStringArena::grow(size_t size) noexcept
+{
+    const size_t page = _M_huge_pages ? HUGE_PAGE_SIZE : static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t blockSize = size + sizeof(Block);
+    if (blockSize < BLOCK_SIZE)
+        blockSize = BLOCK_SIZE;
+    blockSize = (blockSize + page - 1) / page * page;
+    void* data = mmap(nullptr, blockSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (data == MAP_FAILED)
+        return false;
+#ifdef MADV_HUGEPAGE
+    // advice only, kernel without transparent huge pages keeps small ones
+    if (_M_huge_pages)
+        madvise(data, blockSize, MADV_HUGEPAGE);
+#endif
+    Block* block = static_cast<Block*>(data);
+    block->_M_next = _M_blocks;
+    block->_M_size = blockSize;
+    _M_blocks = block;
+    _M_top = reinterpret_cast<char*>(block + 1);
+    _M_left = blockSize - sizeof(Block);
+    _M_capacity += blockSize;
+    return true;
+}
+
+bool AMLStringArena::reserve(size_t size) noexcept
+{
+    return _M_left >= size || grow(size);
+}
+
+/*
+ *  Slot of equal string or empty slot where it belongs, index must not be full
+ */
+std::string_view* AMLStringArena::slot(std::string_view str) noexcept
+{
+    const size_t mask = _M_index_size - 1;
+    for (size_t i = _T_AM_StringItemBase::ceHash(str) & mask; ; i = (i + 1) & mask) {
+        std::string_view& entry = _M_index[i];
+        if (entry.data() == nullptr || entry == str)
+            return &entry;
+    }
+}
+
+/*
+ *  Index twice as big is taken from blocks like strings, no heap allocation is left to arena
+ */
+bool AMLStringArena::rehash() noexcept
+{
+    const size_t size = _M_index_size ? _M_index_size * 2 : 256;
+    const size_t bytes = size * sizeof(std::string_view);
+    const size_t align = alignof(std::string_view);
+    size_t padding = -reinterpret_cast<uintptr_t>(_M_top) & (align - 1);
+    if (_M_left < padding + bytes) {
+        if (!grow(bytes))
+            return false;
+        padding = -reinterpret_cast<uintptr_t>(_M_top) & (align - 1);
+    }
+    std::string_view* index = reinterpret_cast<std::string_view*>(_M_top + padding);
+    for (size_t i = 0; i < size; ++i)
+        new (index + i) std::string_view();
+    _M_top += padding + bytes;
+    _M_left -= padding + bytes;
+
+    std::string_view* old = _M_index;
+    const size_t oldSize = _M_index_size;
+    _M_index = index;
+    _M_index_size = size;
+    for (size_t i = 0; i < oldSize; ++i) {
+        if (old[i].data())
+            *slot(old[i]) = old[i];
+    }
+    return true;
+}
+
+std::string_view AMLStringArena::store(std::string_view str) noexcept
+{
+    // index is kept at most half full
+    if (2 * (_M_index_count + 1) > _M_index_size && !rehash())
+        return std::string_view();
+    std::string_view* entry = slot(str);
+    if (entry->data())
+        return *entry;
+    const size_t size = str.size() + 1;
+    if (_M_left < size && !grow(size))
+        return std::string_view();
+    char* copy = _M_top;
+    memcpy(copy, str.data(), str.size());
+    copy[str.size()] = '\0';
+    _M_top += size;
+    _M_left -= size;
+    _M_size += size;
+    *entry = std::string_view(copy, str.size());
+    ++_M_index_count;
+    return *entry;
+}
+
+void AMLStringArena::release() noexcept
+{
+    while (_M_blocks) {
+        Block* block = _M_blocks;
+        _M_blocks = block->_M_next;
+        munmap(block, block->_M_size);
+    }
+    _M_top = nullptr;
+    _M_left = 0;
+    _M_size = 0;
+    _M_capacity = 0;
+    _M_index = nullptr;
+    _M_index_size = 0;
+    _M_index_count = 0;
+}
+
+}//namespace
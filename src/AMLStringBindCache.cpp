@@ -0,0 +1,223 @@
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <link.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../AMLString.h"
+#include "../AMLStringCatalog.h"
+
+namespace AMCore {
+
+/*
+ *  Bind cache file: header followed by one entry per item of table in list order. Entry points
+ *  translation of item into catalog, so binding with the same build and catalog compares no string.
+ */
+struct _T_AM_StringBindCacheHeader
+{
+    uint32_t    _M_magic;
+    uint32_t    _M_version;
+    uint64_t    _M_catalog_size;
+    uint64_t    _M_catalog_checksum;
+    uint64_t    _M_table_hash;
+    uint64_t    _M_objects_hash;        // build-ids of all loaded objects
+    uint32_t    _M_build_id_length;
+    uint8_t     _M_build_id[32];        // main program
+    uint32_t    _M_entry_count;         // key ends here
+    uint32_t    _M_matched;
+};
+
+struct _T_AM_StringBindCacheEntry
+{
+    uint64_t    _M_hash;            // item is checked by hash and ordinal
+    uint32_t    _M_ordinal;
+    uint32_t    _M_offset;          // into catalog, ORIGINAL for item string
+    uint32_t    _M_length;
+    uint32_t    _M_reserved;
+};
+
+static const uint32_t BIND_CACHE_MAGIC = 0x424c4d41;   // "AMLB"
+static const uint32_t BIND_CACHE_VERSION = 2;
+static const uint32_t ORIGINAL = ~uint32_t(0);
+
+/*
+ *  Build-ids of loaded objects, main program is reported first. Object linked without build-id
+ *  has empty one, its strings are still checked by cache entries.
+ */
+static int collectBuildIds(struct dl_phdr_info* info, size_t, void* data)
+{
+    std::vector<std::string>* ids = static_cast<std::vector<std::string>*>(data);
+    ids->emplace_back();
+    for (int i = 0; i < info->dlpi_phnum; ++i) {
+        const ElfW(Phdr)& phdr = info->dlpi_phdr[i];
+        if (phdr.p_type != PT_NOTE)
+            continue;
+        const char* p = reinterpret_cast<const char*>(info->dlpi_addr + phdr.p_vaddr);
+        const char* end = p + phdr.p_memsz;
+        while (p + sizeof(ElfW(Nhdr)) <= end) {
+            const ElfW(Nhdr)* note = reinterpret_cast<const ElfW(Nhdr)*>(p);
+            const char* name = p + sizeof(ElfW(Nhdr));
+            const char* desc = name + ((note->n_namesz + 3) & ~3u);
+            if (note->n_type == NT_GNU_BUILD_ID && note->n_namesz == 4 && memcmp(name, "GNU", 4) == 0) {
+                ids->back().assign(desc, note->n_descsz);
+                return 0;
+            }
+            p = desc + ((note->n_descsz + 3) & ~3u);
+        }
+    }
+    return 0;
+}
+
+/*
+ *  Shared libraries and plugins registering strings are rebuilt apart from the program, all of
+ *  them identify the build. Objects are listed again for every cache, plugins may be loaded
+ *  between languages.
+ */
+struct _T_AM_StringBuildId
+{
+    std::string _M_program;         // empty if program was linked without --build-id, cache is not used then
+    uint64_t    _M_objects_hash;
+
+    _T_AM_StringBuildId() :
+        _M_objects_hash(AMCEFNV1aAlgorithm::fnv1a64(""))
+    {
+        std::vector<std::string> ids;
+        dl_iterate_phdr(collectBuildIds, &ids);
+        if (!ids.empty() && ids.front().size() <= sizeof(_T_AM_StringBindCacheHeader::_M_build_id))
+            _M_program = ids.front();
+        // FNV1a of ids with their lengths, build-ids contain zeros
+        for (const std::string& id : ids) {
+            const uint64_t size = id.size();
+            _M_objects_hash = _T_AM_StringItemBase::ceHash(
+                std::string_view(reinterpret_cast<const char*>(&size), sizeof(size)), _M_objects_hash);
+            _M_objects_hash = _T_AM_StringItemBase::ceHash(id, _M_objects_hash);
+        }
+    }
+};
+
+static bool readFile(const char* name, std::vector<char>& data)
+{
+    int fd = ::open(name, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    bool ok = fstat(fd, &st) == 0;
+    if (ok) {
+        data.resize(st.st_size);
+        ok = ::read(fd, data.data(), data.size()) == static_cast<ssize_t>(data.size());
+    }
+    ::close(fd);
+    return ok;
+}
+
+/*
+ *  Written to temporary file and renamed, concurrent readers see old or new cache only
+ */
+static void writeFile(const char* name, const std::vector<char>& data)
+{
+    const std::string temporary = std::string(name) + ".tmp." + std::to_string(getpid());
+    int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+        return;
+    const bool ok = ::write(fd, data.data(), data.size()) == static_cast<ssize_t>(data.size());
+    ::close(fd);
+    if (!ok || rename(temporary.c_str(), name) != 0)
+        unlink(temporary.c_str());
+}
+
+static _T_AM_StringBindCacheHeader cacheHeader(const AMLStringCatalog& catalog, uint64_t tableHash,
+                                               const _T_AM_StringBuildId& buildId)
+{
+    _T_AM_StringBindCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    header._M_magic = BIND_CACHE_MAGIC;
+    header._M_version = BIND_CACHE_VERSION;
+    header._M_objects_hash = buildId._M_objects_hash;
+    header._M_build_id_length = static_cast<uint32_t>(buildId._M_program.size());
+    memcpy(header._M_build_id, buildId._M_program.data(), buildId._M_program.size());
+    header._M_catalog_size = catalog.size();
+    header._M_catalog_checksum = catalog.checksum();
+    header._M_table_hash = tableHash;
+    return header;
+}
+
+int AMLStringLanguage::loadCached(const char* name, const char* cacheName, const char* table)
+{
+    _T_AM_StringList* list = _T_AM_StringList::GetStringTable(table);
+    if (!list)
+        return -1;
+    AMLStringCatalog* catalog = new AMLStringCatalog();
+    if (!catalog->open(name)) {
+        delete catalog;
+        return -1;
+    }
+    _M_catalogs.push_back(catalog);
+    const _T_AM_StringBuildId buildId;
+    if (buildId._M_program.empty())
+        return static_cast<int>(bind(*list, *catalog).matched);
+
+    const _T_AM_StringBindCacheHeader expected = cacheHeader(*catalog, list->_M_name_hash, buildId);
+    std::vector<char> data;
+    if (readFile(cacheName, data) && data.size() >= sizeof(expected) &&
+        memcmp(data.data(), &expected, offsetof(_T_AM_StringBindCacheHeader, _M_entry_count)) == 0) {
+        _T_AM_StringBindCacheHeader header;
+        memcpy(&header, data.data(), sizeof(header));
+        const _T_AM_StringBindCacheEntry* entry = reinterpret_cast<const _T_AM_StringBindCacheEntry*>(
+            data.data() + sizeof(header));
+        const _T_AM_StringBindCacheEntry* end = entry + header._M_entry_count;
+        bool valid = (data.size() - sizeof(header)) / sizeof(*entry) == header._M_entry_count;
+        // items registered since the cache was written do not match its entries
+        const _T_AM_StringItemRange items = list->items();
+        _T_AM_StringItemBase* const* it = items.begin();
+        for (; valid && it != items.end() && entry != end; ++it, ++entry) {
+            const _T_AM_StringItemBase* p = *it;
+            const uint32_t ordinal = p->getOrdinal();
+            // translation must end inside catalog with its terminator, c_str() reads up to it
+            if (entry->_M_hash != p->_M_hash || entry->_M_ordinal != ordinal ||
+                (entry->_M_offset != ORIGINAL && (entry->_M_offset >= catalog->size() ||
+                                                  entry->_M_length >= catalog->size() - entry->_M_offset ||
+                                                  catalog->data()[entry->_M_offset + entry->_M_length] != '\0'))) {
+                valid = false;
+                break;
+            }
+            const uint32_t index = ordinal - _M_base;
+            if (index >= _M_count)
+                continue;
+            if (entry->_M_offset == ORIGINAL)
+                _M_views[index] = {p->getSourceString(), static_cast<uint32_t>(p->getSourceLength())};
+            else
+                _M_views[index] = {catalog->data() + entry->_M_offset, entry->_M_length};
+        }
+        if (valid && it == items.end() && entry == end) {
+            _M_plural_rule.parseHeader(catalog->header());
+            return static_cast<int>(header._M_matched);
+        }
+    }
+
+    // views overwritten by a stale cache are bound again
+    const AMLStringBindReport report = bind(*list, *catalog);
+    std::vector<char> cache(sizeof(expected));
+    for (_T_AM_StringItemBase* p : list->items()) {
+        _T_AM_StringBindCacheEntry entry = {p->_M_hash, p->getOrdinal(), ORIGINAL, 0, 0};
+        const uint32_t index = entry._M_ordinal - _M_base;
+        if (index < _M_count && catalog->contains(_M_views[index]._M_str)) {
+            entry._M_offset = static_cast<uint32_t>(_M_views[index]._M_str - catalog->data());
+            entry._M_length = _M_views[index]._M_length;
+        }
+        const char* bytes = reinterpret_cast<const char*>(&entry);
+        cache.insert(cache.end(), bytes, bytes + sizeof(entry));
+    }
+    _T_AM_StringBindCacheHeader header = expected;
+    header._M_entry_count = static_cast<uint32_t>((cache.size() - sizeof(header)) / sizeof(_T_AM_StringBindCacheEntry));
+    header._M_matched = static_cast<uint32_t>(report.matched);
+    memcpy(cache.data(), &header, sizeof(header));
+    writeFile(cacheName, cache);
+    return static_cast<int>(report.matched);
+}
+
+}//namespace
@@ -0,0 +1,177 @@
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../AMLString.h"
+#include "../AMLStringCatalog.h"
+
+namespace AMCore {
+
+static const uint32_t MO_MAGIC = 0x950412de;
+static const uint32_t MO_MAGIC_SWAPPED = 0xde120495;
+
+AMLStringCatalog::AMLStringCatalog() noexcept :
+    _M_data(nullptr),
+    _M_size(0),
+    _M_count(0),
+    _M_original_table(nullptr),
+    _M_translation_table(nullptr),
+    _M_swapped(false)
+{}
+
+AMLStringCatalog::~AMLStringCatalog()
+{
+    close();
+}
+
+bool AMLStringCatalog::open(const char* fileName)
+{
+    close();
+    int fd = ::open(fileName, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < 28) {
+        ::close(fd);
+        return false;
+    }
+    void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED)
+        return false;
+
+    _M_data = static_cast<const char*>(data);
+    _M_size = st.st_size;
+    const uint32_t* header = reinterpret_cast<const uint32_t*>(_M_data);
+    if (header[0] == MO_MAGIC)
+        _M_swapped = false;
+    else if (header[0] == MO_MAGIC_SWAPPED)
+        _M_swapped = true;
+    else {
+        close();
+        return false;
+    }
+    const uint32_t revision = word(header, 1);
+    const uint32_t count = word(header, 2);
+    const uint32_t originals = word(header, 3);
+    const uint32_t translations = word(header, 4);
+    if ((revision >> 16) > 1 || (originals & 3) || (translations & 3) ||
+        originals > _M_size || (_M_size - originals) / 8 < count ||
+        translations > _M_size || (_M_size - translations) / 8 < count) {
+        close();
+        return false;
+    }
+    _M_original_table = reinterpret_cast<const uint32_t*>(_M_data + originals);
+    _M_translation_table = reinterpret_cast<const uint32_t*>(_M_data + translations);
+    _M_count = count;
+
+    // every string must lie inside the file and be terminated
+    for (uint32_t i = 0; i < 2 * count; i += 2) {
+        if (!validString(_M_original_table, i) || !validString(_M_translation_table, i)) {
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+uint64_t AMLStringCatalog::checksum() const noexcept
+{
+    return _T_AM_StringItemBase::ceHash(std::string_view(_M_data, _M_size));
+}
+
+bool AMLStringCatalog::validString(const uint32_t* table, uint32_t index) const noexcept
+{
+    const uint32_t length = word(table, index);
+    const uint32_t offset = word(table, index + 1);
+    return offset < _M_size && _M_size - offset > length && _M_data[offset + length] == '\0';
+}
+
+void AMLStringCatalog::close() noexcept
+{
+    if (_M_data)
+        munmap(const_cast<char*>(_M_data), _M_size);
+    _M_data = nullptr;
+    _M_size = 0;
+    _M_count = 0;
+    _M_original_table = nullptr;
+    _M_translation_table = nullptr;
+    _M_swapped = false;
+}
+
+uint32_t AMLStringCatalog::find(const char* original) const noexcept
+{
+    uint32_t low = 0;
+    uint32_t high = _M_count;
+    while (low < high) {
+        const uint32_t middle = low + (high - low) / 2;
+        const int cmp = strcmp(original, getOriginalString(middle));
+        if (cmp == 0)
+            return middle;
+        if (cmp < 0)
+            high = middle;
+        else
+            low = middle + 1;
+    }
+    return _M_count;
+}
+
+AMLStringCompiledCatalog* AMLStringCompiledCatalog::_M_root = nullptr;
+
+AMLStringCompiledCatalog::AMLStringCompiledCatalog(const char* name, const char* header, const char* data,
+                                                   const AMLStringCompiledEntry* entries, uint32_t count,
+                                                   AMLStringPerfectHash perfectHash, const uint32_t* slots) noexcept :
+    _M_name(name),
+    _M_header(header),
+    _M_data(data),
+    _M_entries(entries),
+    _M_count(count),
+    _M_perfect_hash(perfectHash),
+    _M_slots(slots),
+    _M_next(_M_root)
+{
+    _M_root = this;
+}
+
+AMLStringCompiledCatalog::~AMLStringCompiledCatalog()
+{
+    AMLStringCompiledCatalog** pp = &_M_root;
+    while (*pp && *pp != this)
+        pp = &(*pp)->_M_next;
+    if (*pp)
+        *pp = _M_next;
+}
+
+const AMLStringCompiledCatalog* AMLStringCompiledCatalog::find(const char* name) noexcept
+{
+    for (const AMLStringCompiledCatalog* catalog = _M_root; catalog; catalog = catalog->_M_next) {
+        if (strcmp(catalog->_M_name, name) == 0)
+            return catalog;
+    }
+    return nullptr;
+}
+
+uint32_t AMLStringCompiledCatalog::find(uint64_t hash) const noexcept
+{
+    if (_M_slots) {
+        if (_M_perfect_hash.size() == 0)
+            return _M_count;
+        const uint32_t index = _M_slots[_M_perfect_hash(hash)];
+        return _M_entries[index]._M_hash == hash ? index : _M_count;
+    }
+    uint32_t low = 0;
+    uint32_t high = _M_count;
+    while (low < high) {
+        const uint32_t middle = low + (high - low) / 2;
+        if (_M_entries[middle]._M_hash < hash)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return (low < _M_count && _M_entries[low]._M_hash == hash) ? low : _M_count;
+}
+
+}//namespace
@@ -0,0 +1,334 @@
+#include <algorithm>
+#include <mutex>
+
+#include "../AMLString.h"
+#include "../AMLStringCatalog.h"
+
+namespace AMCore {
+
+std::atomic<const AMLStringLanguage*> AMLStringLanguage::_M_active(nullptr);
+std::atomic<const AMLStringLanguage*> AMLStringLanguage::_M_slots[AMLSTRING_MAX_LANGUAGES] = {};
+__thread _T_AM_StringContext* _T_AM_StringContext::_M_current = nullptr;
+
+// guards list of retired languages and list of readers
+static std::mutex g_reclaim_mutex;
+// incremented by every retirement, readers remember the value seen in their last quiescent state
+static std::atomic<uint64_t> g_reclaim_epoch(1);
+static AMLStringLanguage* g_retired_languages = nullptr;
+static AMLStringReader* g_readers = nullptr;
+
+AMLStringLanguage::AMLStringLanguage() :
+    _M_base(0),
+    _M_count(_T_AM_StringList::finalizeAll()),
+    _M_views(new _T_AM_StringView[_M_count]()),
+    _M_retired_epoch(0),
+    _M_next_retired(nullptr)
+{
+    // strings of named domains stay absent, they are resolved by their own tables
+    const uint64_t defaultHash = AMCEFNV1aAlgorithm::fnv1a64("default");
+    for (_T_AM_StringList* list = _T_AM_StringList::_M_root; list; list = list->_M_next) {
+        if (list->_M_name_hash == defaultHash)
+            fillOriginals(list);
+    }
+}
+
+AMLStringLanguage::AMLStringLanguage(const char* domain) :
+    AMLStringLanguage(_T_AM_StringList::GetStringTable(domain))
+{}
+
+AMLStringLanguage::AMLStringLanguage(_T_AM_StringList* list) :
+    _M_base(0),
+    _M_count(0),
+    _M_views(nullptr),
+    _M_retired_epoch(0),
+    _M_next_retired(nullptr)
+{
+    const uint32_t itemCount = _T_AM_StringList::finalizeAll();
+    if (list) {
+        // ordinals of one domain are mostly contiguous, they are registered by the same module
+        uint32_t first = UINT32_MAX;
+        uint32_t last = 0;
+        uint32_t count = 0;
+        for (_T_AM_StringItemBase* p : list->items()) {
+            const uint32_t ordinal = p->getOrdinal();
+            if (ordinal >= itemCount)
+                continue;
+            first = std::min(first, ordinal);
+            last = std::max(last, ordinal);
+            ++count;
+        }
+        if (count) {
+            _M_base = first;
+            _M_count = last - first + 1;
+        }
+        // items of other domains inside the range stay absent, they are resolved by their tables
+        _M_views = new _T_AM_StringView[_M_count]();
+        fillOriginals(list);
+    }
+    else
+        _M_views = new _T_AM_StringView[0];
+}
+
+void AMLStringLanguage::fillOriginals(_T_AM_StringList* list)
+{
+    for (_T_AM_StringItemBase* p : list->items()) {
+        const uint32_t index = p->getOrdinal() - _M_base;
+        if (index < _M_count)
+            _M_views[index] = {p->getSourceString(), static_cast<uint32_t>(p->getSourceLength())};
+    }
+}
+
+AMLStringLanguage::~AMLStringLanguage()
+{
+    delete[] _M_views;
+    for (AMLStringCatalog* catalog : _M_catalogs)
+        delete catalog;
+}
+
+int AMLStringLanguage::load(const char* name, const char* table)
+{
+    _T_AM_StringList* list = _T_AM_StringList::GetStringTable(table);
+    if (!list)
+        return -1;
+    AMLStringCatalog* catalog = new AMLStringCatalog();
+    if (!catalog->open(name)) {
+        delete catalog;
+        return -1;
+    }
+    _M_catalogs.push_back(catalog);
+    return static_cast<int>(bind(*list, *catalog).matched);
+}
+
+int AMLStringLanguage::read(const char* name, const char* table)
+{
+    _T_AM_StringList* list = _T_AM_StringList::GetStringTable(table);
+    if (!list)
+        return -1;
+    AMLStringCatalog catalog;
+    if (!catalog.open(name))
+        return -1;
+    // all translations fit one block unless arena holds strings already
+    size_t size = 0;
+    for (uint32_t i = 0; i < catalog.count(); ++i)
+        size += catalog.getTranslatedLength(i) + 1;
+    if (!_M_arena.reserve(size))
+        return -1;
+    const int matched = static_cast<int>(bind(*list, catalog).matched);
+    for (uint32_t i = 0; i < _M_count; ++i) {
+        _T_AM_StringView& view = _M_views[i];
+        if (!catalog.contains(view._M_str))
+            continue;
+        const std::string_view copy = _M_arena.store(std::string_view(view._M_str, view._M_length));
+        view = {copy.data(), static_cast<uint32_t>(copy.size())};
+    }
+    return matched;
+}
+
+bool AMLStringLanguage::set(const AMLString& string, std::string_view translation)
+{
+    const _T_AM_StringItemBase* item = string.item();
+    if (item->getOrdinal() == _T_AM_StringItemBase::UNREGISTERED)
+        return false;
+    _T_AM_StringView* view = const_cast<_T_AM_StringView*>(find(item->getOrdinal()));
+    if (!view)
+        return false;
+    const std::string_view copy = _M_arena.store(translation);
+    if (!copy.data())
+        return false;
+    *view = {copy.data(), static_cast<uint32_t>(copy.size())};
+    return true;
+}
+
+int AMLStringLanguage::loadCompiled(const char* catalogName, const char* table)
+{
+    _T_AM_StringList* list = _T_AM_StringList::GetStringTable(table);
+    const AMLStringCompiledCatalog* catalog = AMLStringCompiledCatalog::find(catalogName);
+    if (!list || !catalog)
+        return -1;
+    return static_cast<int>(bind(*list, *catalog).matched);
+}
+
+int AMLStringLanguage::load(std::initializer_list<const char*> names, const char* table)
+{
+    _T_AM_StringList* list = _T_AM_StringList::GetStringTable(table);
+    if (!list)
+        return -1;
+    std::vector<const AMLStringCatalog*> layers;
+    bool opened = false;
+    for (const char* name : names) {
+        AMLStringCatalog* catalog = new AMLStringCatalog();
+        if (!catalog->open(name)) {
+            delete catalog;
+            layers.push_back(nullptr);
+            continue;
+        }
+        _M_catalogs.push_back(catalog);
+        layers.push_back(catalog);
+        opened = true;
+    }
+    if (!opened)
+        return -1;
+    return static_cast<int>(bind(*list, layers.data(), layers.size()).matched);
+}
+
+int AMLStringLanguage::loadCompiled(std::initializer_list<const char*> catalogNames, const char* table)
+{
+    _T_AM_StringList* list = _T_AM_StringList::GetStringTable(table);
+    if (!list)
+        return -1;
+    std::vector<const AMLStringCompiledCatalog*> layers;
+    bool found = false;
+    for (const char* name : catalogNames) {
+        layers.push_back(AMLStringCompiledCatalog::find(name));
+        found |= layers.back() != nullptr;
+    }
+    if (!found)
+        return -1;
+    return static_cast<int>(bind(*list, layers.data(), layers.size()).matched);
+}
+
+AMLStringBindReport AMLStringLanguage::bind(_T_AM_StringList& list, const AMLStringCatalog& catalog, unsigned threads)
+{
+    _M_plural_rule.parseHeader(catalog.header());
+    return list.bindItems(catalog, _M_views, _M_base, _M_count, threads);
+}
+
+AMLStringBindReport AMLStringLanguage::bind(_T_AM_StringList& list, const AMLStringCompiledCatalog& catalog)
+{
+    _M_plural_rule.parseHeader(catalog.header());
+    return list.bindItems(catalog, _M_views, _M_base, _M_count);
+}
+
+AMLStringFallbackReport AMLStringLanguage::bind(_T_AM_StringList& list, const AMLStringCatalog* const* catalogs,
+                                                size_t count)
+{
+    // plural rule is taken from the first layer having it
+    for (size_t i = 0; i < count; ++i) {
+        if (catalogs[i] && _M_plural_rule.parseHeader(catalogs[i]->header()))
+            break;
+    }
+    return list.bindItems(catalogs, count, _M_views, _M_base, _M_count);
+}
+
+AMLStringFallbackReport AMLStringLanguage::bind(_T_AM_StringList& list, const AMLStringCompiledCatalog* const* catalogs,
+                                                size_t count)
+{
+    for (size_t i = 0; i < count; ++i) {
+        if (catalogs[i] && _M_plural_rule.parseHeader(catalogs[i]->header()))
+            break;
+    }
+    return list.bindItems(catalogs, count, _M_views, _M_base, _M_count);
+}
+
+const AMLStringLanguage* AMLStringLanguage::activate(const AMLStringLanguage* language) noexcept
+{
+    const AMLStringLanguage* previous = _M_active.exchange(language, std::memory_order_acq_rel);
+    // reader sees its own switch at once, language retired later waits for its quiescent state
+    _T_AM_StringContext::pin(language);
+    return previous;
+}
+
+const AMLStringLanguage* AMLStringLanguage::publish(AMLStringLanguageId languageId,
+                                                   const AMLStringLanguage* language) noexcept
+{
+    return _M_slots[languageId].exchange(language, std::memory_order_acq_rel);
+}
+
+void AMLStringLanguage::retire(AMLStringLanguage* language)
+{
+    const AMLStringLanguage* expected = language;
+    _M_active.compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel);
+    for (std::atomic<const AMLStringLanguage*>& slot : _M_slots) {
+        expected = language;
+        slot.compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel);
+    }
+    _T_AM_StringContext::pin(_M_active.load(std::memory_order_acquire));
+    std::lock_guard<std::mutex> lock(g_reclaim_mutex);
+    language->_M_retired_epoch = g_reclaim_epoch.fetch_add(1) + 1;
+    language->_M_next_retired = g_retired_languages;
+    g_retired_languages = language;
+}
+
+/*
+ *  Language published again after retirement must not be deleted
+ */
+bool AMLStringLanguage::published(const AMLStringLanguage* language) noexcept
+{
+    // language of a thread scope is not published, only the one active for all threads
+    if (_M_active.load(std::memory_order_acquire) == language)
+        return true;
+    for (const std::atomic<const AMLStringLanguage*>& slot : _M_slots) {
+        if (slot.load(std::memory_order_acquire) == language)
+            return true;
+    }
+    return false;
+}
+
+size_t AMLStringLanguage::reclaim()
+{
+    std::lock_guard<std::mutex> lock(g_reclaim_mutex);
+    uint64_t safe = UINT64_MAX;
+    for (AMLStringReader* reader = g_readers; reader; reader = reader->_M_next)
+        safe = std::min(safe, reader->_M_epoch.load(std::memory_order_acquire));
+    size_t deleted = 0;
+    AMLStringLanguage** pp = &g_retired_languages;
+    while (*pp) {
+        AMLStringLanguage* language = *pp;
+        if (language->_M_retired_epoch <= safe && !published(language)) {
+            *pp = language->_M_next_retired;
+            delete language;
+            ++deleted;
+        }
+        else
+            pp = &language->_M_next_retired;
+    }
+    return deleted;
+}
+
+/*
+ *  Active language is read after reader is registered with its epoch, language retired before
+ *  the epoch is no longer active and language retired after it waits for the next quiescent state
+ */
+AMLStringReader::AMLStringReader() :
+    _M_epoch(0),
+    _M_context(nullptr, _T_AM_StringContext::overlay())
+{
+    {
+        std::lock_guard<std::mutex> lock(g_reclaim_mutex);
+        _M_epoch.store(g_reclaim_epoch.load());
+        _M_next = g_readers;
+        g_readers = this;
+    }
+    // language of enclosing scope stays selected, otherwise the active one is pinned
+    const _T_AM_StringContext* outer = _M_context._M_previous;
+    const bool scoped = outer && outer->_M_language && !outer->_M_pinned;
+    _M_context._M_language = scoped ? outer->_M_language : nullptr;
+    _M_context._M_pinned = !scoped;
+    _T_AM_StringContext::_M_current = &_M_context;
+    if (_M_context._M_pinned)
+        _T_AM_StringContext::pin(AMLStringLanguage::_M_active.load());
+}
+
+/*
+ *  Pins of enclosing contexts follow the same switches as the pin of this reader
+ */
+AMLStringReader::~AMLStringReader()
+{
+    _T_AM_StringContext::_M_current = _M_context._M_previous;
+    std::lock_guard<std::mutex> lock(g_reclaim_mutex);
+    AMLStringReader** pp = &g_readers;
+    while (*pp != this)
+        pp = &(*pp)->_M_next;
+    *pp = _M_next;
+}
+
+/*
+ *  The same order as in constructor
+ */
+void AMLStringReader::quiescent() noexcept
+{
+    _M_epoch.store(g_reclaim_epoch.load());
+    _T_AM_StringContext::pin(AMLStringLanguage::_M_active.load());
+}
+
+}//namespace
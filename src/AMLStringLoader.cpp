@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <memory>
+#include <string>
+
+#include "../AMLStringLoader.h"
+#include "../AMLStringCatalog.h"
+
+namespace AMCore {
+
+struct AMLStringLoader::Task
+{
+    std::string                 _M_name;
+    std::string                 _M_table;
+    int                         _M_language_id;     // -1 for active language
+    std::promise<int>           _M_result;
+    std::function<void(int)>    _M_done;
+};
+
+AMLStringLoader::AMLStringLoader(unsigned threads, unsigned bindThreads) :
+    _M_stopping(false),
+    // languages loaded at the same time share bind threads, loading thread binds one range itself
+    _M_bind_threads(std::max(bindThreads / std::max(threads, 1u), 1u))
+{
+    for (unsigned i = 0; i < std::max(threads, 1u); ++i)
+        _M_threads.emplace_back(&AMLStringLoader::run, this);
+}
+
+AMLStringLoader::~AMLStringLoader()
+{
+    {
+        std::lock_guard<std::mutex> lock(_M_mutex);
+        _M_stopping = true;
+    }
+    _M_queued.notify_all();
+    for (std::thread& thread : _M_threads)
+        thread.join();
+}
+
+std::future<int> AMLStringLoader::add(int languageId, const char* name, const char* table,
+                                      std::function<void(int)> done)
+{
+    Task* task = new Task();
+    task->_M_name = name;
+    task->_M_table = table;
+    task->_M_language_id = languageId;
+    task->_M_done = std::move(done);
+    std::future<int> result = task->_M_result.get_future();
+    {
+        std::lock_guard<std::mutex> lock(_M_mutex);
+        _M_tasks.push_back(task);
+    }
+    _M_queued.notify_one();
+    return result;
+}
+
+std::future<int> AMLStringLoader::load(const char* name, const char* table)
+{
+    return add(-1, name, table, nullptr);
+}
+
+std::future<int> AMLStringLoader::load(AMLStringLanguageId languageId, const char* name, const char* table)
+{
+    return add(languageId, name, table, nullptr);
+}
+
+void AMLStringLoader::load(AMLStringLanguageId languageId, const char* name, const char* table,
+                           std::function<void(int)> done)
+{
+    add(languageId, name, table, std::move(done));
+}
+
+/*
+ *  Language is bound completely before it is published, readers never see it half bound. Language
+ *  of a named domain covers only its table, without slot it becomes binding of the table, so the
+ *  language active for all threads is kept.
+ */
+int AMLStringLoader::load(const Task& task)
+{
+    _T_AM_StringList* list = _T_AM_StringList::GetStringTable(task._M_table.c_str());
+    std::unique_ptr<AMLStringCatalog> catalog(new AMLStringCatalog());
+    if (!list || !catalog->open(task._M_name.c_str()))
+        return -1;
+    const bool domain = AMCEFNV1aAlgorithm::fnv1a64(task._M_table.c_str()) != AMCEFNV1aAlgorithm::fnv1a64("default");
+    // both are released only when published, exception of bind() deletes them
+    std::unique_ptr<AMLStringLanguage> language(domain ? new AMLStringLanguage(list) : new AMLStringLanguage());
+    language->_M_catalogs.push_back(catalog.get());
+    const AMLStringCatalog& bound = *catalog.release();
+    const int matched = static_cast<int>(language->bind(*list, bound, _M_bind_threads).matched);
+    if (domain && task._M_language_id < 0) {
+        // replaced binding is retired by table
+        list->publishBinding(language.release());
+        return matched;
+    }
+    // loading threads replacing the same language in several slots retire it once
+    std::lock_guard<std::mutex> lock(_M_mutex);
+    const AMLStringLanguage* previous;
+    if (task._M_language_id < 0)
+        previous = AMLStringLanguage::activate(language.release());
+    else
+        previous = AMLStringLanguage::publish(static_cast<AMLStringLanguageId>(task._M_language_id), language.release());
+    // readers may still use replaced language, language published elsewhere stays there
+    if (previous && !AMLStringLanguage::published(previous))
+        AMLStringLanguage::retire(const_cast<AMLStringLanguage*>(previous));
+    return matched;
+}
+
+void AMLStringLoader::run()
+{
+    for (;;) {
+        Task* task;
+        {
+            std::unique_lock<std::mutex> lock(_M_mutex);
+            _M_queued.wait(lock, [this]() { return _M_stopping || !_M_tasks.empty(); });
+            // queued languages are loaded before threads stop
+            if (_M_tasks.empty())
+                return;
+            task = _M_tasks.front();
+            _M_tasks.pop_front();
+        }
+        // exception (e.g. bad_alloc of a large table) fails the task, not the loading thread
+        std::exception_ptr error;
+        int matched = -1;
+        try {
+            matched = load(*task);
+        }
+        catch (...) {
+            error = std::current_exception();
+        }
+        if (error)
+            task->_M_result.set_exception(error);
+        else
+            task->_M_result.set_value(matched);
+        if (task->_M_done)
+            task->_M_done(matched);
+        delete task;
+    }
+}
+
+}//namespace
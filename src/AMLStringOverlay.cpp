@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <cstring>
+
+#include "../AMLString.h"
+#include "../AMLStringCatalog.h"
+
+namespace AMCore {
+
+AMLStringOverlay::AMLStringOverlay(const AMLStringLanguage* language) :
+    _M_language(language)
+{}
+
+AMLStringOverlay::~AMLStringOverlay()
+{
+    for (AMLStringCatalog* catalog : _M_catalogs)
+        delete catalog;
+}
+
+/*
+ *  Merges overrides into sorted ordinals in one pass and rebuilds index. Override replaces current
+ *  translation, the last one of the same ordinal wins.
+ */
+void AMLStringOverlay::merge(std::vector<std::pair<uint32_t, _T_AM_StringView>>& overrides)
+{
+    std::stable_sort(overrides.begin(), overrides.end(),
+        [](const std::pair<uint32_t, _T_AM_StringView>& a, const std::pair<uint32_t, _T_AM_StringView>& b) {
+            return a.first < b.first;
+        });
+    std::vector<uint32_t> ordinals;
+    std::vector<_T_AM_StringView> views;
+    ordinals.reserve(_M_ordinals.size() + overrides.size());
+    views.reserve(_M_ordinals.size() + overrides.size());
+    size_t i = 0;
+    size_t j = 0;
+    while (i < _M_ordinals.size() || j < overrides.size()) {
+        if (j == overrides.size() || (i < _M_ordinals.size() && _M_ordinals[i] < overrides[j].first)) {
+            ordinals.push_back(_M_ordinals[i]);
+            views.push_back(_M_views[i]);
+            ++i;
+            continue;
+        }
+        const uint32_t ordinal = overrides[j].first;
+        if (i < _M_ordinals.size() && _M_ordinals[i] == ordinal)
+            ++i;
+        while (j + 1 < overrides.size() && overrides[j + 1].first == ordinal)
+            ++j;
+        ordinals.push_back(ordinal);
+        views.push_back(overrides[j].second);
+        ++j;
+    }
+    _M_ordinals.swap(ordinals);
+    _M_views.swap(views);
+    buildIndex();
+}
+
+void AMLStringOverlay::buildIndex()
+{
+    _M_summary.clear();
+    _M_summary_rank.clear();
+    _M_masks.clear();
+    _M_mask_rank.clear();
+    if (_M_ordinals.empty())
+        return;
+    _M_summary.assign((_M_ordinals.back() >> 12) + 1, 0);
+    uint32_t lastBlock = ~uint32_t(0);
+    for (size_t i = 0; i < _M_ordinals.size(); ++i) {
+        const uint32_t ordinal = _M_ordinals[i];
+        const uint32_t block = ordinal >> 6;
+        if (block != lastBlock) {
+            _M_summary[block >> 6] |= uint64_t(1) << (block & 63);
+            _M_masks.push_back(0);
+            _M_mask_rank.push_back(static_cast<uint32_t>(i));
+            lastBlock = block;
+        }
+        _M_masks.back() |= uint64_t(1) << (ordinal & 63);
+    }
+    uint32_t rank = 0;
+    for (uint64_t summary : _M_summary) {
+        _M_summary_rank.push_back(rank);
+        rank += __builtin_popcountll(summary);
+    }
+}
+
+bool AMLStringOverlay::set(const AMLString& string, std::string_view translation)
+{
+    return set(&string, &translation, 1) == 1;
+}
+
+size_t AMLStringOverlay::set(const AMLString* strings, const std::string_view* translations, size_t count)
+{
+    std::vector<std::pair<uint32_t, _T_AM_StringView>> overrides;
+    overrides.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        const _T_AM_StringItemBase* item = strings[i].item();
+        // items of linker sections get ordinals when their table is finalized
+        if (item->getOrdinal() == _T_AM_StringItemBase::UNREGISTERED)
+            _T_AM_StringList::finalizeAll();
+        if (item->getOrdinal() == _T_AM_StringItemBase::UNREGISTERED)
+            continue;
+        // replaced translation is kept, arena never moves its strings
+        const std::string_view copy = _M_strings.store(translations[i]);
+        if (!copy.data())
+            continue;
+        overrides.push_back({item->getOrdinal(), {copy.data(), static_cast<uint32_t>(copy.size())}});
+    }
+    if (!overrides.empty())
+        merge(overrides);
+    return overrides.size();
+}
+
+int AMLStringOverlay::load(const char* name, const char* table)
+{
+    _T_AM_StringList* list = _T_AM_StringList::GetStringTable(table);
+    if (!list)
+        return -1;
+    AMLStringCatalog* catalog = new AMLStringCatalog();
+    if (!catalog->open(name)) {
+        delete catalog;
+        return -1;
+    }
+    _M_catalogs.push_back(catalog);
+    std::vector<std::pair<uint32_t, _T_AM_StringView>> overrides;
+    for (_T_AM_StringItemBase* p : list->items()) {
+        const uint32_t index = catalog->find(p->_M_original_str);
+        // entry with empty msgid is the catalog header
+        if (index == catalog->count() || catalog->getOriginalLength(index) == 0 ||
+            catalog->getTranslatedLength(index) == 0)
+            continue;
+        const char* str = catalog->getTranslatedString(index);
+        size_t length = catalog->getTranslatedLength(index);
+        if (catalog->getOriginalLength(index) != p->getOriginalLength())
+            length = strlen(str);
+        overrides.push_back({p->getOrdinal(), {str, static_cast<uint32_t>(length)}});
+    }
+    merge(overrides);
+    return static_cast<int>(overrides.size());
+}
+
+}//namespace
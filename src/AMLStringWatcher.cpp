@@ -0,0 +1,268 @@
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include "../AMLStringWatcher.h"
+#include "../AMLStringCatalog.h"
+
+namespace AMCore {
+
+// previous catalogs kept mapped by incremental reloads, the next reload binds the whole table again
+static const size_t MAX_KEPT_CATALOGS = 4;
+
+struct AMLStringWatcher::Watch
+{
+    std::string         _M_file;            // name within watched directory
+    std::string         _M_path;
+    std::string         _M_table;
+    int                 _M_language_id;     // -1 for active language, or binding of named domain
+    bool                _M_domain;          // language covers only the table
+    int                 _M_descriptor;      // inotify watch of directory
+    AMLStringLanguage*  _M_language;        // published by watcher
+    AMLStringCatalog*   _M_catalog;         // loaded last, owned by language
+};
+
+AMLStringWatcher::AMLStringWatcher() :
+    _M_inotify(inotify_init1(IN_NONBLOCK | IN_CLOEXEC)),
+    _M_wake(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)),
+    _M_running(false),
+    _M_reloads(0)
+{}
+
+AMLStringWatcher::~AMLStringWatcher()
+{
+    stop();
+    for (Watch* watch : _M_watches)
+        delete watch;
+    if (_M_inotify >= 0)
+        close(_M_inotify);
+    if (_M_wake >= 0)
+        close(_M_wake);
+}
+
+/*
+ *  Language of named domain covers only its table, default one would bring back originals of others
+ */
+static AMLStringLanguage* newLanguage(const std::string& table, bool domain)
+{
+    return domain ? new AMLStringLanguage(table.c_str()) : new AMLStringLanguage();
+}
+
+/*
+ *  Language of watch replaces whatever was published before. Named domain without slot becomes
+ *  binding of its table, so the language active for all threads is kept. Replaced binding is
+ *  retired by the table.
+ */
+void AMLStringWatcher::publish(const Watch& watch, _T_AM_StringList* list, AMLStringLanguage* language)
+{
+    if (watch._M_language_id >= 0)
+        AMLStringLanguage::publish(static_cast<AMLStringLanguageId>(watch._M_language_id), language);
+    else if (watch._M_domain)
+        list->publishBinding(language);
+    else
+        AMLStringLanguage::activate(language);
+}
+
+int AMLStringWatcher::add(int languageId, const char* name, const char* table)
+{
+    _T_AM_StringList* list = _T_AM_StringList::GetStringTable(table);
+    if (!list || _M_inotify < 0)
+        return -1;
+    Watch* watch = new Watch();
+    watch->_M_path = name;
+    const size_t slash = watch->_M_path.rfind('/');
+    const std::string directory = slash == std::string::npos ? "." : watch->_M_path.substr(0, slash + 1);
+    watch->_M_file = slash == std::string::npos ? watch->_M_path : watch->_M_path.substr(slash + 1);
+    watch->_M_table = table;
+    watch->_M_language_id = languageId;
+    watch->_M_domain = AMCEFNV1aAlgorithm::fnv1a64(table) != AMCEFNV1aAlgorithm::fnv1a64("default");
+    // catalog is opened first, watch of directory may be shared with other files and is never removed
+    watch->_M_catalog = new AMLStringCatalog();
+    if (!watch->_M_catalog->open(name)) {
+        delete watch->_M_catalog;
+        delete watch;
+        return -1;
+    }
+    // directory is watched, file replaced by rename is a new inode
+    watch->_M_descriptor = inotify_add_watch(_M_inotify, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (watch->_M_descriptor < 0) {
+        delete watch->_M_catalog;
+        delete watch;
+        return -1;
+    }
+    watch->_M_language = newLanguage(watch->_M_table, watch->_M_domain);
+    watch->_M_language->_M_catalogs.push_back(watch->_M_catalog);
+    const int matched = static_cast<int>(watch->_M_language->bind(*list, *watch->_M_catalog).matched);
+    std::lock_guard<std::mutex> lock(_M_mutex);
+    _M_watches.push_back(watch);
+    // language published before belongs to caller, it is not retired, binding is retired by table
+    publish(*watch, list, watch->_M_language);
+    return matched;
+}
+
+int AMLStringWatcher::watch(const char* name, const char* table)
+{
+    return add(-1, name, table);
+}
+
+int AMLStringWatcher::watch(AMLStringLanguageId languageId, const char* name, const char* table)
+{
+    return add(languageId, name, table);
+}
+
+/*
+ *  Translation of item in catalog as bound by _T_AM_StringList::bind(), original string if catalog
+ *  does not translate it
+ */
+static _T_AM_StringView translation(const AMLStringCatalog& catalog, const _T_AM_StringItemBase* p)
+{
+    const uint32_t index = catalog.find(p->_M_original_str);
+    if (index == catalog.count() || catalog.getOriginalLength(index) == 0 || catalog.getTranslatedLength(index) == 0)
+        return {p->getSourceString(), static_cast<uint32_t>(p->getSourceLength())};
+    const char* str = catalog.getTranslatedString(index);
+    if (catalog.getOriginalLength(index) != p->getOriginalLength())
+        return {str, static_cast<uint32_t>(strlen(str))};
+    return {str, static_cast<uint32_t>(catalog.getTranslatedLength(index))};
+}
+
+static bool sameEntry(const AMLStringCatalog& a, uint32_t i, const AMLStringCatalog& b, uint32_t j)
+{
+    return a.getOriginalLength(i) == b.getOriginalLength(j) && a.getTranslatedLength(i) == b.getTranslatedLength(j) &&
+           memcmp(a.getOriginalString(i), b.getOriginalString(j), a.getOriginalLength(i)) == 0 &&
+           memcmp(a.getTranslatedString(i), b.getTranslatedString(j), a.getTranslatedLength(i)) == 0;
+}
+
+static std::string_view msgid(const AMLStringCatalog& catalog, uint32_t index)
+{
+    return std::string_view(catalog.getOriginalString(index), catalog.getOriginalLength(index));
+}
+
+/*
+ *  Msgids of entries added, changed or removed, both catalogs are sorted by original
+ */
+static std::vector<std::string_view> changedMsgids(const AMLStringCatalog& previous, const AMLStringCatalog& current)
+{
+    std::vector<std::string_view> changed;
+    uint32_t i = 0;
+    uint32_t j = 0;
+    while (i < previous.count() || j < current.count()) {
+        int cmp;
+        if (i == previous.count())
+            cmp = 1;
+        else if (j == current.count())
+            cmp = -1;
+        else
+            cmp = strcmp(previous.getOriginalString(i), current.getOriginalString(j));
+        if (cmp < 0)
+            changed.push_back(msgid(previous, i++));
+        else if (cmp > 0)
+            changed.push_back(msgid(current, j++));
+        else {
+            if (!sameEntry(previous, i, current, j))
+                changed.push_back(msgid(current, j));
+            ++i;
+            ++j;
+        }
+    }
+    return changed;
+}
+
+bool AMLStringWatcher::reload(Watch& watch)
+{
+    _T_AM_StringList* list = _T_AM_StringList::GetStringTable(watch._M_table.c_str());
+    AMLStringCatalog* catalog = new AMLStringCatalog();
+    if (!list || !catalog->open(watch._M_path.c_str())) {
+        delete catalog;
+        return false;
+    }
+    AMLStringLanguage* previous = watch._M_language;
+    AMLStringLanguage* language = newLanguage(watch._M_table, watch._M_domain);
+    // items registered since previous language was created need whole table bound
+    if (language->_M_base == previous->_M_base && language->_M_count == previous->_M_count &&
+        previous->_M_catalogs.size() < MAX_KEPT_CATALOGS) {
+        std::copy(previous->_M_views, previous->_M_views + previous->_M_count, language->_M_views);
+        // unchanged translations point into catalogs of previous language, they move with them
+        language->_M_catalogs.swap(previous->_M_catalogs);
+        language->_M_catalogs.push_back(catalog);
+        language->_M_plural_rule.parseHeader(catalog->header());
+        // singular and plural strings of one msgid are all bound to its entry
+        for (std::string_view changed : changedMsgids(*watch._M_catalog, *catalog)) {
+            for (const _T_AM_StringItemBase* p : list->findAll(changed)) {
+                const uint32_t index = p->getOrdinal() - language->_M_base;
+                if (index < language->_M_count)
+                    language->_M_views[index] = translation(*catalog, p);
+            }
+        }
+    }
+    else {
+        language->_M_catalogs.push_back(catalog);
+        language->bind(*list, *catalog);
+    }
+    watch._M_language = language;
+    watch._M_catalog = catalog;
+    publish(watch, list, language);
+    // readers may still use previous language, program reclaims it when its readers are quiescent
+    if (watch._M_language_id >= 0 || !watch._M_domain)
+        AMLStringLanguage::retire(previous);
+    _M_reloads.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+size_t AMLStringWatcher::poll(int timeout)
+{
+    struct pollfd fds[2] = {{_M_inotify, POLLIN, 0}, {_M_wake, POLLIN, 0}};
+    if (::poll(fds, 2, timeout) <= 0)
+        return 0;
+    if (fds[1].revents & POLLIN) {
+        uint64_t value;
+        if (read(_M_wake, &value, sizeof(value)) < 0)
+            return 0;
+    }
+    size_t reloaded = 0;
+    alignas(struct inotify_event) char buffer[4096];
+    ssize_t length;
+    while ((length = read(_M_inotify, buffer, sizeof(buffer))) > 0) {
+        for (char* p = buffer; p < buffer + length; ) {
+            const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(p);
+            p += sizeof(struct inotify_event) + event->len;
+            if (!event->len)
+                continue;
+            std::lock_guard<std::mutex> lock(_M_mutex);
+            for (Watch* watch : _M_watches) {
+                if (watch->_M_descriptor == event->wd && watch->_M_file == event->name && reload(*watch))
+                    ++reloaded;
+            }
+        }
+    }
+    return reloaded;
+}
+
+void AMLStringWatcher::run()
+{
+    while (_M_running.load(std::memory_order_acquire))
+        poll(-1);
+}
+
+bool AMLStringWatcher::start()
+{
+    if (_M_running.exchange(true))
+        return false;
+    _M_thread = std::thread(&AMLStringWatcher::run, this);
+    return true;
+}
+
+void AMLStringWatcher::stop()
+{
+    if (!_M_running.exchange(false))
+        return;
+    const uint64_t one = 1;
+    if (write(_M_wake, &one, sizeof(one)) < 0) {}
+    _M_thread.join();
+}
+
+}//namespace
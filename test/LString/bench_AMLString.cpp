@@ -0,0 +1,483 @@
+#include <iostream>
+#include <chrono>
+#include <fstream>
+#include <cstring>
+#include <random>
+#include <algorithm>
+#include <set>
+#include <thread>
+#include <unordered_map>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#include "../../AMLString.h"
+#include "../../AMLStringCatalog.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+using namespace AMCore;
+
+/*
+ *  Table of generated strings, registered at runtime the same way static initializers do it
+ */
+class BenchTable
+{
+public:
+    std::vector<std::string>          _M_texts;
+    std::vector<_T_AM_StringItemBase> _M_items;
+    std::vector<AMLString>            _M_strings;
+
+    BenchTable(size_t count)
+    {
+        using Holder = _T_AM_StringListHolder<AMCEFNV1aAlgorithm::fnv1a64("bench")>;
+        _M_texts.reserve(count);
+        _M_items.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            _M_texts.push_back("bench string " + std::to_string(i));
+            _M_items.emplace_back(_M_texts.back().c_str());
+            Holder::registerItem(&_M_items.back());
+        }
+        for (size_t i = 0; i < count; ++i)
+            _M_strings.push_back(_M_items[i].getAMLString());
+        std::shuffle(_M_strings.begin(), _M_strings.end(), std::mt19937(42));
+    }
+
+    static BenchTable& instance()
+    {
+        static BenchTable table(100000);
+        return table;
+    }
+};
+
+template<typename F>
+static double measure(const char* name, size_t count, F resolve)
+{
+    const size_t rounds = 20;
+    size_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < rounds; ++r)
+        checksum += resolve();
+    auto end = std::chrono::steady_clock::now();
+    const double ns = std::chrono::duration<double, std::nano>(end - start).count() / (rounds * count);
+    printf("%-40s %8zu strings %8.2f ns/string (%zu)\n", name, count, ns, checksum);
+    return ns;
+}
+
+static size_t resolveAll(const std::vector<AMLString>& strings, size_t count)
+{
+    size_t sum = 0;
+    for (size_t i = 0; i < count; ++i)
+        sum += strings[i].c_str()[0] + strings[i].size();
+    return sum;
+}
+
+TEST(AMLStringBench, ThreadLanguage) {
+    const std::vector<AMLString>& strings = BenchTable::instance()._M_strings;
+    AMLStringLanguage* language = new AMLStringLanguage();
+    for (size_t count : {1000, 100000}) {
+        measure("c_str() item string", count, [&]() { return resolveAll(strings, count); });
+        AMLStringLanguage::activate(language);
+        measure("c_str() active language", count, [&]() { return resolveAll(strings, count); });
+        AMLStringLanguage::activate(nullptr);
+        {
+            AMLStringLanguageScope scope(language);
+            measure("c_str() thread language", count, [&]() { return resolveAll(strings, count); });
+        }
+    }
+    AMLStringLanguage::retire(language);
+    AMLStringLanguage::reclaim();
+}
+
+/*
+ *  Item layout before hot/cold split: translation, ordinal, originals and list link interleaved
+ */
+struct InterleavedItem
+{
+    const char*      _M_str;
+    int              _M_length;
+    uint32_t         _M_ordinal;
+    uint64_t         _M_hash;
+    const char*      _M_original_str;
+    int              _M_original_length;
+    int              _M_context_length;
+    InterleavedItem* _M_next;
+};
+
+/*
+ *  L1 data cache read misses of calling thread, -1 if counters are not available
+ */
+class CacheMissCounter
+{
+    int _M_fd = -1;
+public:
+    CacheMissCounter()
+    {
+#ifdef __linux__
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                      (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        _M_fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+
+    ~CacheMissCounter()
+    {
+#ifdef __linux__
+        if (_M_fd >= 0)
+            close(_M_fd);
+#endif
+    }
+
+    void start()
+    {
+#ifdef __linux__
+        if (_M_fd >= 0) {
+            ioctl(_M_fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(_M_fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    long long stop()
+    {
+        long long count = -1;
+#ifdef __linux__
+        if (_M_fd >= 0) {
+            ioctl(_M_fd, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(_M_fd, &count, sizeof(count)) != sizeof(count))
+                count = -1;
+        }
+#endif
+        return count;
+    }
+};
+
+/*
+ *  Every frame starts with cold caches and resolves labels spread over the whole table
+ */
+template<typename F>
+static void measureFrames(const char* name, size_t count, const std::set<uintptr_t>& lines, F resolve)
+{
+    static std::vector<char> evict(64 << 20);
+    const size_t frames = 20;
+    CacheMissCounter counter;
+    double ns = 0;
+    long long misses = 0;
+    size_t checksum = 0;
+    for (size_t frame = 0; frame < frames; ++frame) {
+        for (size_t i = 0; i < evict.size(); i += 64)
+            evict[i] += 1;
+        counter.start();
+        auto start = std::chrono::steady_clock::now();
+        checksum += resolve();
+        auto end = std::chrono::steady_clock::now();
+        const long long frameMisses = counter.stop();
+        misses = (misses < 0 || frameMisses < 0) ? -1 : misses + frameMisses;
+        ns += std::chrono::duration<double, std::nano>(end - start).count();
+    }
+    char missText[32] = "n/a";
+    if (misses >= 0)
+        snprintf(missText, sizeof(missText), "%.2f", double(misses) / (frames * count));
+    printf("%-28s %8zu strings %8.2f ns/string %6zu lines/frame %6s L1D misses/string (%zu)\n", name, count,
+           ns / (frames * count), lines.size(), missText, checksum);
+}
+
+/*
+ *  1000 static strings, their slots are placed by the compiler and linker like slots of any "_" string
+ */
+#define BENCH_LABEL(a, b, c) _("static label " #a #b #c),
+#define BENCH_LABELS_10(a, b) BENCH_LABEL(a, b, 0) BENCH_LABEL(a, b, 1) BENCH_LABEL(a, b, 2) BENCH_LABEL(a, b, 3) \
+    BENCH_LABEL(a, b, 4) BENCH_LABEL(a, b, 5) BENCH_LABEL(a, b, 6) BENCH_LABEL(a, b, 7) BENCH_LABEL(a, b, 8) \
+    BENCH_LABEL(a, b, 9)
+#define BENCH_LABELS_100(a) BENCH_LABELS_10(a, 0) BENCH_LABELS_10(a, 1) BENCH_LABELS_10(a, 2) BENCH_LABELS_10(a, 3) \
+    BENCH_LABELS_10(a, 4) BENCH_LABELS_10(a, 5) BENCH_LABELS_10(a, 6) BENCH_LABELS_10(a, 7) BENCH_LABELS_10(a, 8) \
+    BENCH_LABELS_10(a, 9)
+
+static std::vector<AMLString> staticLabels()
+{
+    return {BENCH_LABELS_100(0) BENCH_LABELS_100(1) BENCH_LABELS_100(2) BENCH_LABELS_100(3) BENCH_LABELS_100(4)
+            BENCH_LABELS_100(5) BENCH_LABELS_100(6) BENCH_LABELS_100(7) BENCH_LABELS_100(8) BENCH_LABELS_100(9)};
+}
+
+/*
+ *  Lines of a frame are those of slots and of translation entries, both are 16 bytes. Slots of runtime
+ *  items come from one pool, slots of static strings lie where the compiler puts them.
+ */
+TEST(AMLStringBench, HotColdFrame) {
+    {
+        std::vector<AMLString> frame = staticLabels();
+        std::shuffle(frame.begin(), frame.end(), std::mt19937(7));
+        std::set<uintptr_t> slotLines;
+        for (const AMLString& string : frame) {
+            const uint32_t ordinal = AMLStringHandle(string).ordinal();
+            slotLines.insert(reinterpret_cast<uintptr_t>(_T_AM_StringList::slot(ordinal)) >> 6);
+            slotLines.insert(reinterpret_cast<uintptr_t>(&_T_AM_StringList::translation(ordinal)) >> 6);
+        }
+        measureFrames("static string slot", frame.size(), slotLines, [&]() {
+            size_t sum = 0;
+            for (const AMLString& string : frame) {
+                const std::string_view view = string.view();
+                sum += view[0] + view.size();
+            }
+            return sum;
+        });
+    }
+    const std::vector<_T_AM_StringItemBase>& items = BenchTable::instance()._M_items;
+    std::vector<InterleavedItem> interleaved(items.size());
+    for (size_t i = 0; i < items.size(); ++i) {
+        const _T_AM_StringItemBase& item = items[i];
+        interleaved[i] = {item.getSourceString(), static_cast<int>(item.getSourceLength() + 1), item.getOrdinal(),
+                          item.getHash(), item.getOriginalString(), static_cast<int>(item.getOriginalLength() + 1),
+                          0, nullptr};
+    }
+    for (size_t count : {1000, 4000, 16000}) {
+        // labels of one screen are registered one after another, they are read in any order
+        std::vector<size_t> order(count);
+        for (size_t i = 0; i < count; ++i)
+            order[i] = items.size() / 2 + i;
+        std::shuffle(order.begin(), order.end(), std::mt19937(7));
+        std::vector<AMLString> frame;
+        std::vector<const InterleavedItem*> labels;
+        std::set<uintptr_t> slotLines;
+        std::set<uintptr_t> itemLines;
+        for (size_t i = 0; i < count; ++i) {
+            frame.push_back(items[order[i]].getAMLString());
+            labels.push_back(&interleaved[order[i]]);
+            slotLines.insert(reinterpret_cast<uintptr_t>(items[order[i]]._M_slot) >> 6);
+            slotLines.insert(reinterpret_cast<uintptr_t>(&_T_AM_StringList::translation(items[order[i]].getOrdinal())) >> 6);
+            itemLines.insert(reinterpret_cast<uintptr_t>(labels.back()) >> 6);
+        }
+        measureFrames("pooled item slot", count, slotLines, [&]() {
+            size_t sum = 0;
+            for (const AMLString& string : frame) {
+                const std::string_view view = string.view();
+                sum += view[0] + view.size();
+            }
+            return sum;
+        });
+        measureFrames("interleaved item", count, itemLines, [&]() {
+            size_t sum = 0;
+            for (size_t i = 0; i < count; ++i) {
+                // same checks as view() does before it reads item
+                if (AMLStringOverlay::active() || AMLStringLanguage::active())
+                    continue;
+                const InterleavedItem* p = labels[i];
+                sum += p->_M_str[0] + (p->_M_length - 1);
+            }
+            return sum;
+        });
+    }
+}
+
+TEST(AMLStringBench, BatchResolve) {
+    const std::vector<AMLString>& strings = BenchTable::instance()._M_strings;
+    std::vector<AMLStringHandle> handles(strings.begin(), strings.end());
+    std::vector<std::string_view> views(strings.size());
+    AMLStringLanguage* language = new AMLStringLanguage();
+    AMLStringLanguage::activate(language);
+    auto sum = [&](size_t count) {
+        size_t s = 0;
+        for (size_t i = 0; i < count; ++i)
+            s += views[i].size();
+        return s;
+    };
+    for (size_t count : {1000, 10000, 100000}) {
+        measure("view() loop", count, [&]() {
+            for (size_t i = 0; i < count; ++i)
+                views[i] = strings[i].view();
+            return sum(count);
+        });
+        measure("AMLString::resolve()", count, [&]() {
+            AMLString::resolve(strings.data(), count, views.data());
+            return sum(count);
+        });
+        measure("handle view() loop", count, [&]() {
+            for (size_t i = 0; i < count; ++i)
+                views[i] = handles[i].view();
+            return sum(count);
+        });
+        measure("AMLStringHandle::resolve()", count, [&]() {
+            AMLStringHandle::resolve(handles.data(), count, views.data());
+            return sum(count);
+        });
+    }
+    AMLStringLanguage::activate(nullptr);
+    AMLStringLanguage::retire(language);
+    AMLStringLanguage::reclaim();
+}
+
+TEST(AMLStringBench, TableLookup) {
+    const size_t count = 100000;
+    BenchTable::instance();
+    measure("GetStringTable(name)", count, [&]() {
+        size_t sum = 0;
+        for (size_t i = 0; i < count; ++i)
+            sum += reinterpret_cast<uintptr_t>(_T_AM_StringList::GetStringTable("bench")) & 1;
+        return sum;
+    });
+    measure("GetStringTable(hash)", count, [&]() {
+        size_t sum = 0;
+        for (size_t i = 0; i < count; ++i)
+            sum += reinterpret_cast<uintptr_t>(_T_AM_StringList::GetStringTable("bench"_hash)) & 1;
+        return sum;
+    });
+    measure("GetStringTable<hash>()", count, [&]() {
+        size_t sum = 0;
+        for (size_t i = 0; i < count; ++i)
+            sum += reinterpret_cast<uintptr_t>(_T_AM_StringList::GetStringTable<"bench"_hash>()) & 1;
+        return sum;
+    });
+}
+
+TEST(AMLStringBench, PerfectHash) {
+    const size_t count = 100000;
+    std::vector<uint64_t> keys;
+    for (size_t i = 0; i < count; ++i)
+        keys.push_back(AMCEFNV1aAlgorithm::fnv1a64(("bench string " + std::to_string(i)).c_str()));
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<uint32_t> displacements;
+    ASSERT_TRUE(AMLStringPerfectHash::build(keys.data(), count, displacements));
+    const AMLStringPerfectHash perfectHash(displacements.data(), displacements.size(), count);
+    // slot holds key to reject strings not built in, and ordinal
+    std::vector<std::pair<uint64_t, uint32_t>> slots(count);
+    for (size_t i = 0; i < count; ++i)
+        slots[perfectHash(keys[i])] = {keys[i], static_cast<uint32_t>(i)};
+    auto end = std::chrono::steady_clock::now();
+    printf("perfect hash built in %.2f ms, %zu bytes of displacements\n",
+           std::chrono::duration<double, std::milli>(end - start).count(), displacements.size() * sizeof(uint32_t));
+
+    std::unordered_map<uint64_t, uint32_t> map;
+    map.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+        map.emplace(keys[i], static_cast<uint32_t>(i));
+
+    std::vector<uint64_t> lookups = keys;
+    std::shuffle(lookups.begin(), lookups.end(), std::mt19937(42));
+    const double mph = measure("AMLStringPerfectHash", count, [&]() {
+        size_t sum = 0;
+        for (uint64_t key : lookups) {
+            const std::pair<uint64_t, uint32_t>& slot = slots[perfectHash(key)];
+            sum += slot.first == key ? slot.second : 0;
+        }
+        return sum;
+    });
+    const double unordered = measure("std::unordered_map", count, [&]() {
+        size_t sum = 0;
+        for (uint64_t key : lookups) {
+            auto it = map.find(key);
+            sum += it != map.end() ? it->second : 0;
+        }
+        return sum;
+    });
+    EXPECT_LT(mph, unordered * 1.5);
+}
+
+TEST(AMLStringBench, DynamicLookup) {
+    const size_t count = 100000;
+    BenchTable::instance();
+    _T_AM_StringList* list = _T_AM_StringList::GetStringTable("bench");
+    std::vector<std::string> hits;
+    std::vector<std::string> misses;
+    for (size_t i = 0; i < count; ++i) {
+        hits.push_back("bench string " + std::to_string(i));
+        misses.push_back("missing string " + std::to_string(i));
+    }
+    std::shuffle(hits.begin(), hits.end(), std::mt19937(42));
+    auto lookupAll = [list](const std::vector<std::string>& keys) {
+        size_t sum = 0;
+        for (const std::string& key : keys)
+            sum += list->find(key) != nullptr;
+        return sum;
+    };
+    list->find(hits[0]);
+    measure("find() hit", count, [&]() { return lookupAll(hits); });
+    measure("find() miss", count, [&]() { return lookupAll(misses); });
+
+    // index is immutable, lookups from threads share no written memory
+    for (size_t threadCount : {1, 2, 4, 8}) {
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        std::atomic<size_t> found(0);
+        for (size_t t = 0; t < threadCount; ++t)
+            threads.emplace_back([&]() { found += lookupAll(hits); });
+        for (std::thread& thread : threads)
+            thread.join();
+        auto end = std::chrono::steady_clock::now();
+        const double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        printf("find() %zu threads %8.2f ms, %8.2f M lookups/s\n", threadCount, ms,
+               threadCount * count / ms / 1000);
+        EXPECT_EQ(threadCount * count, found.load());
+    }
+}
+
+/*
+ *  Writes .mo file translating every other string of bench table, entries sorted by original
+ */
+static void writeCatalog(const std::string& name, size_t count)
+{
+    std::vector<std::pair<std::string, std::string>> entries;
+    for (size_t i = 0; i < count; i += 2)
+        entries.emplace_back("bench string " + std::to_string(i), "přeložený řetězec " + std::to_string(i));
+    std::sort(entries.begin(), entries.end());
+    const uint32_t n = static_cast<uint32_t>(entries.size());
+    std::vector<uint32_t> header = {0x950412de, 0, n, 28, 28 + 8 * n, 0, 28 + 16 * n};
+    std::string strings;
+    std::vector<uint32_t> originals;
+    std::vector<uint32_t> translations;
+    const uint32_t base = 28 + 16 * n;
+    for (const auto& entry : entries) {
+        originals.push_back(static_cast<uint32_t>(entry.first.size()));
+        originals.push_back(base + static_cast<uint32_t>(strings.size()));
+        strings += entry.first + '\0';
+    }
+    for (const auto& entry : entries) {
+        translations.push_back(static_cast<uint32_t>(entry.second.size()));
+        translations.push_back(base + static_cast<uint32_t>(strings.size()));
+        strings += entry.second + '\0';
+    }
+    std::ofstream file(name, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(header.data()), header.size() * 4);
+    file.write(reinterpret_cast<const char*>(originals.data()), originals.size() * 4);
+    file.write(reinterpret_cast<const char*>(translations.data()), translations.size() * 4);
+    file.write(strings.data(), strings.size());
+}
+
+TEST(AMLStringBench, ParallelBind) {
+    const size_t count = 100000;
+    BenchTable::instance();
+    const std::string name = testing::TempDir() + "amlstring_bench.mo";
+    writeCatalog(name, count);
+    AMLStringCatalog catalog;
+    ASSERT_TRUE(catalog.open(name.c_str()));
+    _T_AM_StringList* list = _T_AM_StringList::GetStringTable("bench");
+    AMLStringBindReport expected = {0, 0, 0};
+    for (unsigned threads : {1, 2, 4, 8}) {
+        AMLStringLanguage language("bench");
+        auto start = std::chrono::steady_clock::now();
+        const AMLStringBindReport report = language.bind(*list, catalog, threads);
+        auto end = std::chrono::steady_clock::now();
+        printf("bind() %u threads %8.2f ms\n", threads, std::chrono::duration<double, std::milli>(end - start).count());
+        if (threads == 1)
+            expected = report;
+        EXPECT_EQ(count / 2, report.matched);
+        EXPECT_EQ(expected.missing, report.missing);
+        EXPECT_EQ(expected.orphaned, report.orphaned);
+    }
+    unlink(name.c_str());
+}
+
+int main(int argc, char **argv) {
+
+     ::testing::InitGoogleTest(&argc, argv);
+     return RUN_ALL_TESTS();
+}
@@ -1,4 +1,7 @@
 #include <iostream>
+#include <cstring>
+#include <deque>
+#include <thread>
 #include "../../AMLString.h"
 #include "../../AMBasicCString.h"
 #include "gtest/gtest.h"
@@ -215,6 +218,37 @@ TEST(AMLString, FindTest) {
     EXPECT_EQ(2, mls.find_last_not_of("ABCDEFW", 3));
 }
 
+TEST(AMLString, RegistrationTest) {
+    static _T_AM_StringItemBase items[] = {_T_AM_StringItemBase("zebra"), _T_AM_StringItemBase("ant"),
+                                           _T_AM_StringItemBase("moose"), _T_AM_StringItemBase("bee")};
+    using Holder = _T_AM_StringListHolder<AMCEFNV1aAlgorithm::fnv1a64("registration")>;
+    Holder::registerItem(&items[0]);
+    Holder::registerItem(&items[1]);
+    Holder::registerItem(&items[2]);
+
+    _T_AM_StringList* list = _T_AM_StringList::GetStringTable("registration");
+    EXPECT_NE(list, nullptr);
+    _T_AM_StringItemBase* p = list->_M_first_item;
+    EXPECT_STREQ(p->getOriginalString(), "ant");
+    p = p->getNextItem();
+    EXPECT_STREQ(p->getOriginalString(), "moose");
+    p = p->getNextItem();
+    EXPECT_STREQ(p->getOriginalString(), "zebra");
+    EXPECT_EQ(p->getNextItem(), nullptr);
+
+    Holder::registerItem(&items[3]);
+    list = _T_AM_StringList::GetStringTable("registration");
+    p = list->_M_first_item;
+    EXPECT_STREQ(p->getOriginalString(), "ant");
+    p = p->getNextItem();
+    EXPECT_STREQ(p->getOriginalString(), "bee");
+    p = p->getNextItem();
+    EXPECT_STREQ(p->getOriginalString(), "moose");
+    p = p->getNextItem();
+    EXPECT_STREQ(p->getOriginalString(), "zebra");
+    EXPECT_EQ(p->getNextItem(), nullptr);
+}
+
 TEST(AMLString, SpeedDemo) {
     printf("Start\n");
     AMLString foxl = _("fox");
@@ -222,6 +256,127 @@ TEST(AMLString, SpeedDemo) {
     printf("%s\n", foxc);
 }
 
+TEST(AMLString, IdTest) {
+    EXPECT_EQ(AMCEFNV1aAlgorithm::fnv1a64("fox"), _("fox").id());
+    EXPECT_EQ(_("fox").id(), _("fox").id());
+    EXPECT_NE(_("fox").id(), _("brown").id());
+    EXPECT_EQ(AMCEFNV1aAlgorithm::fnv1a64("zebra"), _T_AM_StringItemBase("zebra").getHash());
+
+    static constexpr _T_AM_StringItemBase item("ant");
+    static_assert(item.getHash() == AMCEFNV1aAlgorithm::fnv1a64("ant"), "hash is not constant");
+}
+
+TEST(AMLString, DirectoryTest) {
+    EXPECT_EQ(_T_AM_StringList::GetStringTable("default"), _T_AM_StringList::GetStringTable<"default"_hash>());
+    EXPECT_EQ(_T_AM_StringList::GetStringTable("default"), _T_AM_StringList::GetStringTable("default"_hash));
+    EXPECT_EQ(nullptr, _T_AM_StringList::GetStringTable("nonexistent"));
+
+    _T_AM_StringList* first = _T_AM_StringList::GetStringTable<"chunk"_hash>();
+    _T_AM_StringList* second = _T_AM_StringList::GetStringTable<"chunk second"_hash>();
+    EXPECT_EQ(first, _T_AM_StringList::GetStringTable("chunk"));
+    EXPECT_EQ(1, first->chunks().size());
+    EXPECT_EQ(first, *first->chunks().begin());
+
+    first->Add(*second);
+    _T_AM_StringListRange chunks = first->chunks();
+    ASSERT_EQ(2, chunks.size());
+    EXPECT_EQ(first, chunks.begin()[0]);
+    EXPECT_EQ(second, chunks.begin()[1]);
+    chunks = second->chunks();
+    ASSERT_EQ(2, chunks.size());
+    EXPECT_EQ(second, chunks.begin()[0]);
+    EXPECT_EQ(first, chunks.begin()[1]);
+}
+
+TEST(AMLString, DomainTest) {
+    AMLString errorFox = _D("errors", "fox");
+    AMLString fox = _("fox");
+    EXPECT_STREQ("fox", errorFox.getOriginalString());
+    EXPECT_NE(fox.getOriginalString(), errorFox.getOriginalString());
+    EXPECT_EQ(fox.id(), errorFox.id());
+
+    _T_AM_StringList* errors = _T_AM_StringList::GetStringTable("errors");
+    ASSERT_NE(nullptr, errors);
+    EXPECT_EQ(errors, _T_AM_StringList::GetStringTable<"errors"_hash>());
+    EXPECT_STREQ("fox", errors->_M_first_item->getOriginalString());
+    EXPECT_EQ(nullptr, errors->_M_first_item->getNextItem());
+}
+
+TEST(AMLString, ContextTest) {
+    AMLString menuOpen = _DC("ui", "menu", "Open");
+    AMLString stateOpen = _DC("ui", "state", "Open");
+    AMLString open = _D("ui", "Open");
+    EXPECT_STREQ("Open", menuOpen.c_str());
+    EXPECT_EQ(4, menuOpen.size());
+    EXPECT_STREQ("Open", menuOpen.getOriginalString());
+    EXPECT_EQ("menu", menuOpen.getContext());
+    EXPECT_EQ("", open.getContext());
+    EXPECT_NE(menuOpen.c_str(), stateOpen.c_str());
+    EXPECT_EQ(AMCEFNV1aAlgorithm::fnv1a64("menu\x04Open"), menuOpen.id());
+    EXPECT_NE(menuOpen.id(), stateOpen.id());
+    EXPECT_NE(menuOpen.id(), open.id());
+}
+
+TEST(AMLString, LookupTest) {
+    AMLString menuOpen = _DC("ui", "menu", "Open");
+    AMLString open = _D("ui", "Open");
+    _T_AM_StringList* list = _T_AM_StringList::GetStringTable("ui");
+    ASSERT_NE(nullptr, list);
+    ASSERT_NE(nullptr, list->find("Open"));
+    EXPECT_EQ(open.id(), list->find("Open")->getHash());
+    const std::string key = std::string("menu") + '\x04' + "Open";
+    ASSERT_NE(nullptr, list->find(key));
+    EXPECT_EQ(menuOpen.id(), list->find(key)->getHash());
+    EXPECT_EQ(nullptr, list->find("Close"));
+    EXPECT_EQ(nullptr, list->find("Ope"));
+    EXPECT_EQ(open.id(), list->find("Open", menuOpen).id());
+    EXPECT_EQ(open.c_str(), list->find("Open", menuOpen).c_str());
+    EXPECT_EQ(menuOpen.id(), list->find("Close", menuOpen).id());
+
+    // strings registered later are found once table is indexed again
+    static _T_AM_StringItemBase items[] = {_T_AM_StringItemBase("lookup one"), _T_AM_StringItemBase("lookup two")};
+    using Holder = _T_AM_StringListHolder<AMCEFNV1aAlgorithm::fnv1a64("lookup")>;
+    Holder::registerItem(&items[0]);
+    _T_AM_StringList* lookup = _T_AM_StringList::GetStringTable("lookup");
+    EXPECT_EQ(&items[0], lookup->find("lookup one"));
+    EXPECT_EQ(nullptr, lookup->find("lookup two"));
+    Holder::registerItem(&items[1]);
+    EXPECT_EQ(&items[1], lookup->find("lookup two"));
+    EXPECT_EQ(&items[0], lookup->find("lookup one"));
+}
+
+TEST(AMLString, OrderTest) {
+    using Holder = _T_AM_StringListHolder<AMCEFNV1aAlgorithm::fnv1a64("order")>;
+    static std::vector<std::string> texts;
+    static std::deque<_T_AM_StringItemBase> items;
+    for (int i = 0; i < 2000; ++i)
+        texts.push_back("order " + std::to_string((i * 7919) % 2000));
+    items.emplace_back(texts[0].c_str());
+    Holder::registerItem(&items.back());
+    _T_AM_StringList* list = _T_AM_StringList::GetStringTable("order");
+    const _T_AM_StringItemRange first = list->items();
+    ASSERT_EQ(1, first.size());
+
+    // snapshots stay sorted and complete while another thread registers and finalizes
+    std::thread registering([]() {
+        for (size_t i = 1; i < texts.size(); ++i) {
+            items.emplace_back(texts[i].c_str());
+            Holder::registerItem(&items.back());
+            _T_AM_StringList::GetStringTable("order");
+        }
+    });
+    size_t walked = 0;
+    while (walked < texts.size()) {
+        const _T_AM_StringItemRange range = list->items();
+        for (size_t i = 1; i < range.size(); ++i)
+            ASSERT_LT(strcmp(range.begin()[i - 1]->getOriginalString(), range.begin()[i]->getOriginalString()), 0);
+        walked = range.size();
+    }
+    registering.join();
+    EXPECT_EQ(1, first.size());
+    EXPECT_STREQ("order 0", (*first.begin())->getOriginalString());
+}
+
 int main(int argc, char **argv) {
 
      ::testing::InitGoogleTest(&argc, argv);
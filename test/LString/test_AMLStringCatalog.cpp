@@ -0,0 +1,304 @@
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <unistd.h>
+#include "../../AMLString.h"
+#include "../../AMLStringCatalog.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+using namespace AMCore;
+
+static const std::string g_data_dir = AMLSTRING_TEST_DATA;
+
+TEST(AMLStringCatalog, OpenTest) {
+    AMLStringCatalog catalog;
+    EXPECT_EQ(false, catalog.isOpen());
+    EXPECT_EQ(false, catalog.open((g_data_dir + "/nonexistent.mo").c_str()));
+    EXPECT_EQ(false, catalog.open((g_data_dir + "/cs.po").c_str()));
+    EXPECT_EQ(false, catalog.isOpen());
+
+    EXPECT_EQ(true, catalog.open((g_data_dir + "/cs.mo").c_str()));
+    EXPECT_EQ(true, catalog.isOpen());
+    EXPECT_EQ(9, catalog.count());
+
+    EXPECT_STREQ("", catalog.getOriginalString(0));
+    EXPECT_NE(nullptr, strstr(catalog.getTranslatedString(0), "Language: cs"));
+
+    uint32_t index = catalog.find("fox");
+    EXPECT_NE(catalog.count(), index);
+    EXPECT_STREQ("fox", catalog.getOriginalString(index));
+    EXPECT_EQ(3, catalog.getOriginalLength(index));
+    EXPECT_STREQ("liška", catalog.getTranslatedString(index));
+    EXPECT_EQ(strlen("liška"), catalog.getTranslatedLength(index));
+
+    EXPECT_EQ(catalog.count(), catalog.find("dog"));
+
+    catalog.close();
+    EXPECT_EQ(false, catalog.isOpen());
+    EXPECT_EQ(0, catalog.count());
+}
+
+TEST(AMLStringCatalog, LoadTest) {
+    AMLString texts[] = {_("welcome"), _("quick"), _("brown"), _("fox"), _("lazy dog")};
+
+    _T_AM_StringList* list = _T_AM_StringList::GetStringTable("default");
+    EXPECT_NE(list, nullptr);
+
+    EXPECT_EQ(-1, list->Load((g_data_dir + "/nonexistent.mo").c_str()));
+    EXPECT_STREQ("fox", texts[3].c_str());
+
+    EXPECT_EQ(4, list->Load((g_data_dir + "/cs.mo").c_str()));
+    EXPECT_STREQ("vítejte", texts[0].c_str());
+    EXPECT_STREQ("rychlá", texts[1].c_str());
+    EXPECT_STREQ("hnědá", texts[2].c_str());
+    EXPECT_STREQ("liška", texts[3].c_str());
+    EXPECT_STREQ("lazy dog", texts[4].c_str());
+    EXPECT_EQ(strlen("hnědá"), texts[2].size());
+    EXPECT_EQ(texts[3], "liška");
+    EXPECT_STREQ("fox", texts[3].getOriginalString());
+
+    list->Unload();
+    EXPECT_STREQ("welcome", texts[0].c_str());
+    EXPECT_STREQ("fox", texts[3].c_str());
+    EXPECT_EQ(3, texts[3].size());
+}
+
+TEST(AMLStringCatalog, BindTest) {
+    AMLStringCatalog catalog;
+    EXPECT_EQ(true, catalog.open((g_data_dir + "/cs.mo").c_str()));
+
+    _T_AM_StringList* list = _T_AM_StringList::GetStringTable("default");
+    EXPECT_NE(list, nullptr);
+
+    AMLStringBindReport report = list->bind(catalog);
+    EXPECT_EQ(4, report.matched);
+    EXPECT_EQ(1, report.missing);   // "lazy dog"
+    EXPECT_EQ(4, report.orphaned);  // "jumps over", "%d file", "menu|Open", "state|Open"
+    EXPECT_STREQ("liška", _("fox").c_str());
+    EXPECT_STREQ("lazy dog", _("lazy dog").c_str());
+
+    AMLStringCatalog empty;
+    report = list->bind(empty);
+    EXPECT_EQ(0, report.matched);
+    EXPECT_EQ(5, report.missing);
+    EXPECT_EQ(0, report.orphaned);
+    EXPECT_STREQ("fox", _("fox").c_str());
+}
+
+TEST(AMLStringCatalog, CompiledTest) {
+    EXPECT_EQ(nullptr, AMLStringCompiledCatalog::find("nonexistent"));
+    const AMLStringCompiledCatalog* catalog = AMLStringCompiledCatalog::find("cs");
+    ASSERT_NE(nullptr, catalog);
+    EXPECT_STREQ("cs", catalog->name());
+    EXPECT_EQ(8, catalog->count());
+    EXPECT_NE(nullptr, strstr(catalog->header(), "Language: cs"));
+
+    uint32_t index = catalog->find(_("fox").id());
+    EXPECT_NE(catalog->count(), index);
+    const AMLStringCompiledEntry& entry = catalog->entry(index);
+    EXPECT_STREQ("fox", catalog->getOriginalString(entry));
+    EXPECT_EQ(3, entry._M_original_length);
+    EXPECT_STREQ("liška", catalog->getTranslatedString(entry));
+    EXPECT_EQ(strlen("liška"), entry._M_translation_length);
+    EXPECT_EQ(catalog->count(), catalog->find(AMCEFNV1aAlgorithm::fnv1a64("dog")));
+
+    AMLString texts[] = {_("welcome"), _("quick"), _("brown"), _("fox"), _("lazy dog")};
+    _T_AM_StringList* list = _T_AM_StringList::GetStringTable("default");
+    AMLStringBindReport report = list->bind(*catalog);
+    EXPECT_EQ(4, report.matched);
+    EXPECT_EQ(1, report.missing);
+    EXPECT_EQ(4, report.orphaned);
+    EXPECT_STREQ("vítejte", texts[0].c_str());
+    EXPECT_STREQ("liška", texts[3].c_str());
+    EXPECT_EQ(strlen("hnědá"), texts[2].size());
+    EXPECT_STREQ("lazy dog", texts[4].c_str());
+
+    list->Unload();
+    EXPECT_STREQ("fox", texts[3].c_str());
+}
+
+TEST(AMLStringCatalog, PerfectHashTest) {
+    std::vector<uint64_t> hashes;
+    for (int i = 0; i < 1000; ++i)
+        hashes.push_back(AMCEFNV1aAlgorithm::fnv1a64(("string " + std::to_string(i)).c_str()));
+    std::vector<uint32_t> displacements;
+    ASSERT_TRUE(AMLStringPerfectHash::build(hashes.data(), hashes.size(), displacements));
+    EXPECT_EQ(AMLStringPerfectHash::bucketCount(hashes.size()), displacements.size());
+    const AMLStringPerfectHash perfectHash(displacements.data(), displacements.size(), hashes.size());
+    std::vector<bool> taken(hashes.size(), false);
+    for (uint64_t hash : hashes) {
+        const uint32_t slot = perfectHash(hash);
+        ASSERT_LT(slot, hashes.size());
+        EXPECT_FALSE(taken[slot]);
+        taken[slot] = true;
+    }
+
+    hashes.push_back(hashes[10]);
+    EXPECT_FALSE(AMLStringPerfectHash::build(hashes.data(), hashes.size(), displacements));
+
+    // duplicates are rejected before any displacement is tried
+    const uint64_t same[] = {hashes[3], hashes[3]};
+    EXPECT_FALSE(AMLStringPerfectHash::build(same, 2, displacements));
+    std::vector<uint64_t> twice(hashes.begin(), hashes.begin() + 100);
+    twice.insert(twice.end(), hashes.begin(), hashes.begin() + 100);
+    EXPECT_FALSE(AMLStringPerfectHash::build(twice.data(), twice.size(), displacements));
+    EXPECT_TRUE(AMLStringPerfectHash::build(same, 1, displacements));
+    EXPECT_EQ(0, AMLStringPerfectHash(displacements.data(), displacements.size(), 1)(same[0]));
+}
+
+TEST(AMLStringCatalog, PluralTest) {
+    AMLStringPlural files[] = {_DN("files", "%d file", "%d files", 1), _DN("files", "%d file", "%d files", 3),
+                               _DN("files", "%d file", "%d files", 5)};
+    EXPECT_STREQ("%d file", files[0].c_str());
+    EXPECT_STREQ("%d files", files[1].c_str());
+    EXPECT_EQ("%d files", files[1].getOriginalPluralString());
+
+    _T_AM_StringList* list = _T_AM_StringList::GetStringTable("files");
+    ASSERT_NE(nullptr, list);
+    EXPECT_EQ(1, list->Load((g_data_dir + "/cs.mo").c_str()));
+    EXPECT_EQ(AMLStringPluralRule::CZECH, list->pluralRule().family());
+    EXPECT_STREQ("%d soubor", files[0].c_str());
+    EXPECT_STREQ("%d soubory", files[1].c_str());
+    EXPECT_STREQ("%d souborů", files[2].c_str());
+    EXPECT_EQ(strlen("%d soubory"), files[1].size());
+
+    list->Unload();
+    EXPECT_EQ(2, list->pluralRule().forms());
+    EXPECT_STREQ("%d files", files[2].c_str());
+
+    AMLStringBindReport report = list->bind(*AMLStringCompiledCatalog::find("cs"));
+    EXPECT_EQ(1, report.matched);
+    EXPECT_EQ(7, report.orphaned);
+    EXPECT_EQ("%d souborů", files[2].view());
+    list->Unload();
+}
+
+TEST(AMLStringCatalog, ContextTest) {
+    AMLString texts[] = {_DC("ui", "menu", "Open"), _DC("ui", "state", "Open"), _DC("ui", "door", "Open"),
+                         _D("ui", "Open")};
+    _T_AM_StringList* list = _T_AM_StringList::GetStringTable("ui");
+    ASSERT_NE(nullptr, list);
+
+    EXPECT_EQ(2, list->Load((g_data_dir + "/cs.mo").c_str()));
+    EXPECT_STREQ("Otevřít", texts[0].c_str());
+    EXPECT_STREQ("Otevřeno", texts[1].c_str());
+    EXPECT_STREQ("Open", texts[2].c_str());
+    EXPECT_STREQ("Open", texts[3].c_str());
+    EXPECT_STREQ("Open", texts[0].getOriginalString());
+    list->Unload();
+    EXPECT_STREQ("Open", texts[0].c_str());
+    EXPECT_EQ(4, texts[1].size());
+
+    AMLStringBindReport report = list->bind(*AMLStringCompiledCatalog::find("cs"));
+    EXPECT_EQ(2, report.matched);
+    EXPECT_EQ(2, report.missing);
+    EXPECT_STREQ("Otevřít", texts[0].c_str());
+    EXPECT_EQ("Otevřeno", texts[1].view());
+    EXPECT_STREQ("Open", texts[2].c_str());
+    list->Unload();
+}
+
+TEST(AMLStringCatalog, FallbackTest) {
+    AMLString texts[] = {_("welcome"), _("quick"), _("brown"), _("fox"), _("lazy dog")};
+    AMLStringCatalog czech, regional;
+    ASSERT_TRUE(regional.open((g_data_dir + "/cs_CZ.mo").c_str()));
+    ASSERT_TRUE(czech.open((g_data_dir + "/cs.mo").c_str()));
+
+    _T_AM_StringList* list = _T_AM_StringList::GetStringTable("default");
+    const AMLStringCatalog* chain[] = {&regional, nullptr, &czech};
+    AMLStringFallbackReport report = list->bind(chain, 3);
+    EXPECT_EQ(4, report.matched);
+    EXPECT_EQ(1, report.missing);
+    EXPECT_EQ(std::vector<size_t>({1, 0, 3}), report.supplied);
+    EXPECT_EQ(std::vector<int>({2, 0, -1, 2, 2}), report.layers);
+    EXPECT_STREQ("lišák", texts[3].c_str());
+    EXPECT_STREQ("rychlá", texts[1].c_str());
+    EXPECT_STREQ("lazy dog", texts[4].c_str());
+    EXPECT_EQ(3, list->pluralRule().forms());
+
+    const AMLStringCompiledCatalog* compiled[] = {AMLStringCompiledCatalog::find("cs")};
+    report = list->bind(compiled, 1);
+    EXPECT_EQ(4, report.matched);
+    EXPECT_STREQ("liška", texts[3].c_str());
+    list->Unload();
+}
+
+/*
+ *  Writes .mo file of entries sorted by original, without header
+ */
+static void writeCatalog(const std::string& name, std::vector<std::pair<std::string, std::string>> entries)
+{
+    std::sort(entries.begin(), entries.end());
+    const uint32_t n = static_cast<uint32_t>(entries.size());
+    std::vector<uint32_t> header = {0x950412de, 0, n, 28, 28 + 8 * n, 0, 28 + 16 * n};
+    std::vector<uint32_t> originals;
+    std::vector<uint32_t> translations;
+    std::string strings;
+    const uint32_t base = 28 + 16 * n;
+    for (const auto& entry : entries) {
+        originals.push_back(static_cast<uint32_t>(entry.first.size()));
+        originals.push_back(base + static_cast<uint32_t>(strings.size()));
+        strings += entry.first + '\0';
+    }
+    for (const auto& entry : entries) {
+        translations.push_back(static_cast<uint32_t>(entry.second.size()));
+        translations.push_back(base + static_cast<uint32_t>(strings.size()));
+        strings += entry.second + '\0';
+    }
+    std::ofstream file(name, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(header.data()), header.size() * 4);
+    file.write(reinterpret_cast<const char*>(originals.data()), originals.size() * 4);
+    file.write(reinterpret_cast<const char*>(translations.data()), translations.size() * 4);
+    file.write(strings.data(), strings.size());
+}
+
+TEST(AMLStringCatalog, ParallelBindTest) {
+    // more entries than one bind thread looks up
+    const size_t count = 20000;
+    using Holder = _T_AM_StringListHolder<AMCEFNV1aAlgorithm::fnv1a64("parallel")>;
+    std::vector<std::string> texts;
+    std::vector<_T_AM_StringItemBase> items;
+    texts.reserve(count);
+    items.reserve(count + 1);
+    for (size_t i = 0; i < count; ++i) {
+        texts.push_back("parallel " + std::to_string(i));
+        items.emplace_back(texts.back().c_str());
+        Holder::registerItem(&items.back());
+    }
+    // the second item of one original takes the same entry
+    items.emplace_back(texts[2].c_str());
+    Holder::registerItem(&items.back());
+
+    std::vector<std::pair<std::string, std::string>> entries;
+    for (size_t i = 0; i < count; i += 2)
+        entries.emplace_back(texts[i], "paralelní " + std::to_string(i));
+    for (size_t i = 0; i < 10; ++i)
+        entries.emplace_back("unused " + std::to_string(i), "nepoužitý");
+    const std::string name = testing::TempDir() + "amlstring_parallel.mo";
+    writeCatalog(name, entries);
+    AMLStringCatalog catalog;
+    ASSERT_TRUE(catalog.open(name.c_str()));
+
+    _T_AM_StringList* list = _T_AM_StringList::GetStringTable("parallel");
+    ASSERT_NE(list, nullptr);
+    for (unsigned threads : {1u, 4u}) {
+        AMLStringLanguage language("parallel");
+        const AMLStringBindReport report = language.bind(*list, catalog, threads);
+        EXPECT_EQ(count / 2 + 1, report.matched);
+        EXPECT_EQ(count / 2, report.missing);
+        EXPECT_EQ(10, report.orphaned);
+        EXPECT_STREQ("paralelní 2", language.find(items[2].getOrdinal())->_M_str);
+        EXPECT_STREQ("paralelní 2", language.find(items[count].getOrdinal())->_M_str);
+        EXPECT_STREQ("parallel 3", language.find(items[3].getOrdinal())->_M_str);
+        EXPECT_STREQ("paralelní 19998", language.find(items[count - 2].getOrdinal())->_M_str);
+    }
+    unlink(name.c_str());
+}
+
+int main(int argc, char **argv) {
+
+     ::testing::InitGoogleTest(&argc, argv);
+     return RUN_ALL_TESTS();
+}
@@ -0,0 +1,56 @@
+#include <iostream>
+#include <cstring>
+#include "../../AMLString.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+using namespace AMCore;
+
+// translations are resolved by compiler
+static_assert(_("fox").size() == sizeof("liška") - 1, "fox is not translated at compile time");
+static_assert(_("fox").id() == AMCEFNV1aAlgorithm::fnv1a64("fox"), "id is not constant");
+static_assert(_("lazy dog").size() == sizeof("lazy dog") - 1, "missing translation is not original");
+static_assert(_C("menu", "Open").size() == sizeof("Otevřít") - 1, "context is not part of identity");
+static_assert(_N("%d file", "%d files", 5).size() == sizeof("%d souborů") - 1, "plural form is not constant");
+
+TEST(AMLStringFixed, TranslateTest) {
+    constexpr AMLString fox = _("fox");
+    EXPECT_STREQ("liška", fox.c_str());
+    EXPECT_EQ("liška", fox.view());
+    EXPECT_STREQ("fox", fox.getOriginalString());
+    EXPECT_EQ(3, fox.getOriginalLength());
+    EXPECT_STREQ("liška", fox.c_str(1));
+    EXPECT_STREQ("vítejte", _("welcome").c_str());
+    EXPECT_STREQ("lazy dog", _("lazy dog").c_str());
+    EXPECT_EQ(_("brown"), "hnědá");
+}
+
+TEST(AMLStringFixed, PluralTest) {
+    EXPECT_EQ(AMLStringPluralRule::CZECH, _T_AM_StringFixedPluralRule.family());
+    EXPECT_STREQ("%d soubor", _N("%d file", "%d files", 1).c_str());
+    EXPECT_STREQ("%d soubory", _N("%d file", "%d files", 2).c_str());
+    EXPECT_EQ("%d souborů", _N("%d file", "%d files", 5).view());
+    EXPECT_STREQ("liška", _("fox").c_str());
+    EXPECT_STREQ("%d dog", _N("%d dog", "%d dogs", 1).c_str());
+    EXPECT_STREQ("%d dogs", _N("%d dog", "%d dogs", 2).c_str());
+}
+
+TEST(AMLStringFixed, ContextTest) {
+    EXPECT_STREQ("Otevřít", _C("menu", "Open").c_str());
+    EXPECT_STREQ("Otevřeno", _C("state", "Open").c_str());
+    EXPECT_STREQ("Open", _C("door", "Open").c_str());
+    EXPECT_STREQ("Open", _("Open").c_str());
+    EXPECT_EQ("menu", _C("menu", "Open").getContext());
+}
+
+TEST(AMLStringFixed, NoRegistrationTest) {
+    AMLString fox = _("fox");
+    EXPECT_EQ(nullptr, _T_AM_StringList::GetStringTable("default"));
+    EXPECT_STREQ("liška", fox.c_str());
+}
+
+int main(int argc, char **argv) {
+
+     ::testing::InitGoogleTest(&argc, argv);
+     return RUN_ALL_TESTS();
+}
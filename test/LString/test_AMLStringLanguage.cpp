@@ -0,0 +1,878 @@
+#include <iostream>
+#include <cstring>
+#include <fstream>
+#include <thread>
+#include "../../AMLString.h"
+#include "../../AMLStringCatalog.h"
+#include "../../AMLStringLoader.h"
+#include "../../AMLStringWatcher.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+using namespace AMCore;
+
+static const std::string g_data_dir = AMLSTRING_TEST_DATA;
+
+TEST(AMLStringLanguage, SwitchTest) {
+    AMLString texts[] = {_("welcome"), _("quick"), _("brown"), _("fox")};
+
+    AMLStringLanguage* cs = new AMLStringLanguage();
+    EXPECT_EQ(-1, cs->load((g_data_dir + "/cs.mo").c_str(), "blah"));
+    EXPECT_EQ(-1, cs->load((g_data_dir + "/nonexistent.mo").c_str()));
+    EXPECT_EQ(4, cs->load((g_data_dir + "/cs.mo").c_str()));
+    EXPECT_STREQ("fox", texts[3].c_str());
+
+    EXPECT_EQ(nullptr, AMLStringLanguage::activate(cs));
+    EXPECT_EQ(cs, AMLStringLanguage::active());
+    EXPECT_STREQ("liška", texts[3].c_str());
+    EXPECT_EQ(strlen("liška"), texts[3].size());
+    EXPECT_EQ("hnědá", texts[2].view());
+    EXPECT_STREQ("fox", texts[3].getOriginalString());
+
+    EXPECT_EQ(cs, AMLStringLanguage::activate(nullptr));
+    EXPECT_STREQ("fox", texts[3].c_str());
+    EXPECT_EQ("brown", texts[2].view());
+
+    AMLStringLanguage::activate(cs);
+    AMLStringReader reader;
+    AMLStringLanguage::retire(cs);
+    EXPECT_EQ(nullptr, AMLStringLanguage::active());
+    EXPECT_STREQ("fox", texts[3].c_str());
+    EXPECT_EQ(0, AMLStringLanguage::reclaim());
+    reader.quiescent();
+    EXPECT_EQ(1, AMLStringLanguage::reclaim());
+}
+
+TEST(AMLStringLanguage, MultiLanguageTest) {
+    const AMLStringLanguageId CS = 1;
+    const AMLStringLanguageId DE = 2;
+    AMLString fox = _("fox");
+
+    AMLStringLanguage* cs = new AMLStringLanguage();
+    EXPECT_EQ(4, cs->load((g_data_dir + "/cs.mo").c_str()));
+    AMLStringLanguage* de = new AMLStringLanguage();
+    EXPECT_EQ(4, de->load((g_data_dir + "/de.mo").c_str()));
+
+    EXPECT_EQ(nullptr, AMLStringLanguage::publish(CS, cs));
+    EXPECT_EQ(nullptr, AMLStringLanguage::publish(DE, de));
+    EXPECT_EQ(cs, AMLStringLanguage::language(CS));
+
+    EXPECT_STREQ("liška", fox.c_str(CS));
+    EXPECT_STREQ("Fuchs", fox.c_str(DE));
+    EXPECT_STREQ("fox", fox.c_str(3));
+    EXPECT_EQ(strlen("liška"), fox.size(CS));
+    EXPECT_EQ("Fuchs", fox.view(DE));
+    EXPECT_STREQ("fox", fox.c_str());
+    EXPECT_EQ(3, fox.size());
+
+    AMLStringLanguage::activate(de);
+    EXPECT_STREQ("Fuchs", fox.c_str());
+    EXPECT_STREQ("liška", fox.c_str(CS));
+    AMLStringLanguage::activate(nullptr);
+
+    AMLStringReader reader;
+    AMLStringLanguage::retire(cs);
+    AMLStringLanguage::retire(de);
+    EXPECT_EQ(nullptr, AMLStringLanguage::language(CS));
+    EXPECT_STREQ("fox", fox.c_str(DE));
+    reader.quiescent();
+    EXPECT_EQ(2, AMLStringLanguage::reclaim());
+}
+
+TEST(AMLStringLanguage, ScopeTest) {
+    const AMLStringLanguageId CS = 1;
+    const AMLStringLanguageId DE = 2;
+    AMLString fox = _("fox");
+
+    AMLStringLanguage* cs = new AMLStringLanguage();
+    EXPECT_EQ(4, cs->load((g_data_dir + "/cs.mo").c_str()));
+    AMLStringLanguage* de = new AMLStringLanguage();
+    EXPECT_EQ(4, de->load((g_data_dir + "/de.mo").c_str()));
+    AMLStringLanguage::publish(CS, cs);
+    AMLStringLanguage::publish(DE, de);
+
+    std::string csText, deText;
+    std::thread csThread([&csText, fox, CS]() {
+        AMLStringLanguageScope scope(CS);
+        csText = fox.c_str();
+    });
+    std::thread deThread([&deText, fox, de]() {
+        AMLStringLanguageScope scope(de);
+        deText = std::string(fox.view());
+    });
+    csThread.join();
+    deThread.join();
+    EXPECT_EQ("liška", csText);
+    EXPECT_EQ("Fuchs", deText);
+    EXPECT_STREQ("fox", fox.c_str());
+
+    {
+        AMLStringLanguageScope scope(cs);
+        EXPECT_STREQ("liška", fox.c_str());
+        {
+            AMLStringLanguageScope nested(de);
+            EXPECT_STREQ("Fuchs", fox.c_str());
+            EXPECT_EQ(de, AMLStringLanguage::active());
+        }
+        EXPECT_STREQ("liška", fox.c_str());
+    }
+    EXPECT_STREQ("fox", fox.c_str());
+
+    AMLStringLanguage::activate(de);
+    {
+        AMLStringLanguageScope scope(cs);
+        EXPECT_STREQ("liška", fox.c_str());
+    }
+    EXPECT_STREQ("Fuchs", fox.c_str());
+    AMLStringLanguage::activate(nullptr);
+
+    AMLStringReader reader;
+    AMLStringLanguage::retire(cs);
+    AMLStringLanguage::retire(de);
+    // language activated again after retirement is kept, whatever language the reclaiming thread uses
+    AMLStringLanguage::activate(cs);
+    AMLStringLanguage* en = new AMLStringLanguage();
+    {
+        AMLStringLanguageScope scope(en);
+        reader.quiescent();
+        EXPECT_EQ(1, AMLStringLanguage::reclaim());
+    }
+    EXPECT_STREQ("liška", fox.c_str());
+    AMLStringLanguage::activate(nullptr);
+    AMLStringLanguage::retire(en);
+    reader.quiescent();
+    EXPECT_EQ(2, AMLStringLanguage::reclaim());
+}
+
+TEST(AMLStringLanguage, ReaderScopeTest) {
+    AMLString fox = _("fox");
+    AMLStringLanguage* cs = new AMLStringLanguage();
+    EXPECT_EQ(4, cs->load((g_data_dir + "/cs.mo").c_str()));
+    AMLStringLanguage* de = new AMLStringLanguage();
+    EXPECT_EQ(4, de->load((g_data_dir + "/de.mo").c_str()));
+    auto activateElsewhere = [](const AMLStringLanguage* language) {
+        std::thread([language]() { AMLStringLanguage::activate(language); }).join();
+    };
+
+    AMLStringLanguage::activate(cs);
+    {
+        AMLStringReader reader;
+        activateElsewhere(de);
+        EXPECT_STREQ("liška", fox.c_str());
+        EXPECT_EQ(de, AMLStringLanguage::global());
+        {
+            // scope of globally active language and overlay scope keep language pinned by reader
+            AMLStringLanguageScope scope(nullptr);
+            AMLStringOverlayScope overlay(nullptr);
+            EXPECT_EQ(cs, AMLStringLanguage::active());
+            EXPECT_STREQ("liška", fox.c_str());
+            reader.quiescent();
+            EXPECT_STREQ("Fuchs", fox.c_str());
+            activateElsewhere(nullptr);
+            EXPECT_STREQ("Fuchs", fox.c_str());
+        }
+        EXPECT_STREQ("Fuchs", fox.c_str());
+        reader.quiescent();
+        EXPECT_STREQ("fox", fox.c_str());
+        // language activated by reader thread itself is seen at once
+        AMLStringLanguage::activate(cs);
+        EXPECT_STREQ("liška", fox.c_str());
+    }
+    {
+        // reader inside scope leaves its language selected
+        AMLStringLanguageScope scope(de);
+        AMLStringReader reader;
+        EXPECT_STREQ("Fuchs", fox.c_str());
+        reader.quiescent();
+        EXPECT_EQ(de, AMLStringLanguage::active());
+    }
+    EXPECT_STREQ("liška", fox.c_str());
+    AMLStringLanguage::activate(nullptr);
+
+    AMLStringReader reader;
+    AMLStringLanguage::retire(cs);
+    AMLStringLanguage::retire(de);
+    reader.quiescent();
+    EXPECT_EQ(2, AMLStringLanguage::reclaim());
+}
+
+TEST(AMLStringLanguage, CompiledTest) {
+    AMLString fox = _("fox");
+
+    AMLStringLanguage* de = new AMLStringLanguage();
+    EXPECT_EQ(-1, de->loadCompiled("nonexistent"));
+    EXPECT_EQ(-1, de->loadCompiled("de", "blah"));
+    EXPECT_EQ(4, de->loadCompiled("de"));
+
+    AMLStringLanguage::activate(de);
+    EXPECT_STREQ("Fuchs", fox.c_str());
+    EXPECT_EQ("braun", _("brown").view());
+    AMLStringLanguage::activate(nullptr);
+    EXPECT_STREQ("fox", fox.c_str());
+
+    AMLStringReader reader;
+    AMLStringLanguage::retire(de);
+    reader.quiescent();
+    EXPECT_EQ(1, AMLStringLanguage::reclaim());
+}
+
+TEST(AMLStringLanguage, DomainTest) {
+    AMLString errorFox = _D("errors", "fox");
+    AMLString errorDog = _D("errors", "lazy dog");
+    AMLString fox = _("fox");
+
+    AMLStringLanguage* errors = new AMLStringLanguage("errors");
+    EXPECT_EQ(1, errors->load((g_data_dir + "/cs.mo").c_str(), "errors"));
+    {
+        AMLStringLanguageScope scope(errors);
+        EXPECT_STREQ("liška", errorFox.c_str());
+        EXPECT_STREQ("lazy dog", errorDog.c_str());
+        EXPECT_STREQ("fox", fox.c_str());
+    }
+    EXPECT_STREQ("fox", errorFox.c_str());
+
+    AMLStringLanguage* none = new AMLStringLanguage("nonexistent");
+    {
+        AMLStringLanguageScope scope(none);
+        EXPECT_STREQ("fox", errorFox.c_str());
+        EXPECT_STREQ("fox", fox.c_str());
+    }
+
+    _T_AM_StringList* list = _T_AM_StringList::GetStringTable("errors");
+    EXPECT_EQ(1, list->Load((g_data_dir + "/de.mo").c_str()));
+    EXPECT_STREQ("Fuchs", errorFox.c_str());
+    EXPECT_STREQ("fox", fox.c_str());
+
+    // default language leaves domain bound by its table translated
+    AMLStringLanguage* cs = new AMLStringLanguage();
+    EXPECT_EQ(4, cs->load((g_data_dir + "/cs.mo").c_str()));
+    AMLStringLanguage::activate(cs);
+    EXPECT_STREQ("Fuchs", errorFox.c_str());
+    EXPECT_STREQ("liška", fox.c_str());
+    AMLStringLanguage::activate(nullptr);
+    list->Unload();
+    EXPECT_STREQ("fox", errorFox.c_str());
+
+    AMLStringReader reader;
+    AMLStringLanguage::retire(errors);
+    AMLStringLanguage::retire(none);
+    AMLStringLanguage::retire(cs);
+    reader.quiescent();
+    // binding of de.mo was retired by Unload()
+    EXPECT_EQ(4, AMLStringLanguage::reclaim());
+}
+
+TEST(AMLStringLanguage, DomainGapTest) {
+    // ordinals of one domain interleaved with another one
+    static _T_AM_StringItemBase items[] = {_T_AM_StringItemBase("fox"), _T_AM_StringItemBase("brown"),
+                                           _T_AM_StringItemBase("quick")};
+    _T_AM_StringListHolder<AMCEFNV1aAlgorithm::fnv1a64("gap")>::registerItem(&items[0]);
+    _T_AM_StringListHolder<AMCEFNV1aAlgorithm::fnv1a64("gapped")>::registerItem(&items[1]);
+    _T_AM_StringListHolder<AMCEFNV1aAlgorithm::fnv1a64("gap")>::registerItem(&items[2]);
+    AMLString fox = items[0].getAMLString();
+    AMLString brown = items[1].getAMLString();
+    AMLString quick = items[2].getAMLString();
+
+    _T_AM_StringList* gapped = _T_AM_StringList::GetStringTable("gapped");
+    EXPECT_EQ(1, gapped->Load((g_data_dir + "/cs.mo").c_str()));
+    AMLStringLanguage* gap = new AMLStringLanguage("gap");
+    EXPECT_EQ(2, gap->load((g_data_dir + "/cs.mo").c_str(), "gap"));
+    EXPECT_EQ(nullptr, gap->find(items[1].getOrdinal()));
+
+    AMLStringLanguage::activate(gap);
+    EXPECT_STREQ("liška", fox.c_str());
+    EXPECT_STREQ("rychlá", quick.c_str());
+    EXPECT_STREQ("hnědá", brown.c_str());
+    AMLStringLanguage::activate(nullptr);
+    gapped->Unload();
+
+    AMLStringReader reader;
+    AMLStringLanguage::retire(gap);
+    reader.quiescent();
+    EXPECT_EQ(2, AMLStringLanguage::reclaim());
+}
+
+TEST(AMLStringLanguage, PluralTest) {
+    const AMLStringLanguageId CS = 1;
+    const AMLStringLanguageId DE = 2;
+    auto files = [](unsigned long n) {return _DN("files", "%d file", "%d files", n);};
+    EXPECT_STREQ("%d file", files(1).c_str());
+    EXPECT_STREQ("%d files", files(0).c_str());
+    EXPECT_EQ("%d files", files(2).view());
+    EXPECT_STREQ("%d file", files(2).getOriginalString());
+    EXPECT_EQ(2, files(2).count());
+    EXPECT_EQ(AMCEFNV1aAlgorithm::fnv1a64("%d file"), files(2).id());
+
+    AMLStringLanguage* cs = new AMLStringLanguage();
+    EXPECT_EQ(1, cs->load((g_data_dir + "/cs.mo").c_str(), "files"));
+    EXPECT_EQ(AMLStringPluralRule::CZECH, cs->pluralRule().family());
+    AMLStringLanguage* de = new AMLStringLanguage();
+    EXPECT_EQ(1, de->loadCompiled("de", "files"));
+    EXPECT_EQ(AMLStringPluralRule::GERMANIC, de->pluralRule().family());
+    AMLStringLanguage::publish(CS, cs);
+    AMLStringLanguage::publish(DE, de);
+    {
+        AMLStringLanguageScope scope(cs);
+        EXPECT_STREQ("%d soubor", files(1).c_str());
+        EXPECT_STREQ("%d soubory", files(4).c_str());
+        EXPECT_STREQ("%d souborů", files(0).c_str());
+        EXPECT_EQ(strlen("%d souborů"), files(5).size());
+    }
+    EXPECT_STREQ("%d Datei", files(1).c_str(DE));
+    EXPECT_STREQ("%d Dateien", files(3).c_str(DE));
+    EXPECT_EQ("%d souborů", files(11).view(CS));
+    EXPECT_STREQ("%d files", files(3).c_str());
+
+    // language without catalog of the domain keeps original forms
+    AMLStringLanguage* none = new AMLStringLanguage();
+    EXPECT_EQ(4, none->load((g_data_dir + "/cs.mo").c_str()));
+    {
+        AMLStringLanguageScope scope(none);
+        EXPECT_STREQ("%d file", files(1).c_str());
+        EXPECT_STREQ("%d files", files(3).c_str());
+    }
+
+    AMLStringReader reader;
+    AMLStringLanguage::retire(cs);
+    AMLStringLanguage::retire(de);
+    AMLStringLanguage::retire(none);
+    reader.quiescent();
+    EXPECT_EQ(3, AMLStringLanguage::reclaim());
+}
+
+TEST(AMLStringLanguage, FallbackTest) {
+    AMLString texts[] = {_("welcome"), _("quick"), _("brown"), _("fox")};
+
+    AMLStringLanguage* cs = new AMLStringLanguage();
+    EXPECT_EQ(-1, cs->load({(g_data_dir + "/nonexistent.mo").c_str()}));
+    EXPECT_EQ(4, cs->load({(g_data_dir + "/cs_CZ.mo").c_str(), (g_data_dir + "/nonexistent.mo").c_str(),
+                           (g_data_dir + "/cs.mo").c_str()}));
+    // plural rule of cs.mo, cs_CZ.mo has none
+    EXPECT_EQ(AMLStringPluralRule::CZECH, cs->pluralRule().family());
+    {
+        AMLStringLanguageScope scope(cs);
+        EXPECT_STREQ("lišák", texts[3].c_str());
+        EXPECT_STREQ("hnědá", texts[2].c_str());
+        EXPECT_STREQ("vítejte", texts[0].c_str());
+        EXPECT_STREQ("lazy dog", _("lazy dog").c_str());
+    }
+
+    AMLStringCatalog czech, regional;
+    ASSERT_TRUE(regional.open((g_data_dir + "/cs_CZ.mo").c_str()));
+    ASSERT_TRUE(czech.open((g_data_dir + "/cs.mo").c_str()));
+    const AMLStringCatalog* chain[] = {&regional, &czech};
+    AMLStringLanguage* report = new AMLStringLanguage();
+    AMLStringFallbackReport result = report->bind(*_T_AM_StringList::GetStringTable("default"), chain, 2);
+    EXPECT_EQ(4, result.matched);
+    EXPECT_EQ(1, result.missing);
+    ASSERT_EQ(2, result.supplied.size());
+    EXPECT_EQ(1, result.supplied[0]);
+    EXPECT_EQ(3, result.supplied[1]);
+    // items are sorted: brown, fox, lazy dog, quick, welcome
+    EXPECT_EQ(std::vector<int>({1, 0, -1, 1, 1}), result.layers);
+
+    AMLStringLanguage* de = new AMLStringLanguage();
+    EXPECT_EQ(-1, de->loadCompiled({"nonexistent"}));
+    EXPECT_EQ(4, de->loadCompiled({"nonexistent", "de"}));
+    {
+        AMLStringLanguageScope scope(de);
+        EXPECT_STREQ("Fuchs", texts[3].c_str());
+    }
+
+    AMLStringReader reader;
+    AMLStringLanguage::retire(cs);
+    AMLStringLanguage::retire(report);
+    AMLStringLanguage::retire(de);
+    reader.quiescent();
+    EXPECT_EQ(3, AMLStringLanguage::reclaim());
+}
+
+TEST(AMLStringLanguage, OverlayTest) {
+    AMLString fox = _("fox");
+    AMLString brown = _("brown");
+
+    AMLStringLanguage* cs = new AMLStringLanguage();
+    EXPECT_EQ(4, cs->load((g_data_dir + "/cs.mo").c_str()));
+    AMLStringLanguage* de = new AMLStringLanguage();
+    EXPECT_EQ(4, de->load((g_data_dir + "/de.mo").c_str()));
+
+    AMLStringOverlay acme(cs);
+    EXPECT_EQ(0, acme.size());
+    EXPECT_EQ(nullptr, acme.find(0));
+    std::string brand = "ACME liška";
+    EXPECT_TRUE(acme.set(fox, brand));
+    brand.clear();
+    EXPECT_EQ(1, acme.size());
+
+    AMLStringOverlay regional(nullptr);
+    EXPECT_EQ(-1, regional.load((g_data_dir + "/nonexistent.mo").c_str()));
+    EXPECT_EQ(1, regional.load((g_data_dir + "/cs_CZ.mo").c_str()));
+
+    EXPECT_STREQ("fox", fox.c_str());
+    {
+        AMLStringOverlayScope scope(&acme);
+        EXPECT_EQ(&acme, AMLStringOverlay::active());
+        EXPECT_STREQ("ACME liška", fox.c_str());
+        EXPECT_EQ("hnědá", brown.view());
+        {
+            AMLStringOverlayScope nested(&regional);
+            AMLStringLanguageScope language(de);
+            // one context of thread carries both
+            EXPECT_EQ(&regional, AMLStringOverlay::active());
+            EXPECT_EQ(de, AMLStringLanguage::active());
+            EXPECT_STREQ("lišák", fox.c_str());
+            EXPECT_STREQ("braun", brown.c_str());
+        }
+        EXPECT_STREQ("ACME liška", fox.c_str());
+        EXPECT_TRUE(acme.set(fox, "ACME"));
+        EXPECT_EQ("ACME", fox.view());
+        EXPECT_EQ(1, acme.size());
+        // the last translation of a string given twice is kept
+        const AMLString strings[] = {brown, fox, brown};
+        const std::string_view translations[] = {"ACME brown", "ACME fox", "ACME hnědá"};
+        EXPECT_EQ(3, acme.set(strings, translations, 3));
+        EXPECT_EQ(2, acme.size());
+        EXPECT_EQ("ACME fox", fox.view());
+        EXPECT_EQ("ACME hnědá", brown.view());
+    }
+    EXPECT_EQ(nullptr, AMLStringOverlay::active());
+    EXPECT_STREQ("fox", fox.c_str());
+
+    AMLStringReader reader;
+    AMLStringLanguage::retire(cs);
+    AMLStringLanguage::retire(de);
+    reader.quiescent();
+    EXPECT_EQ(2, AMLStringLanguage::reclaim());
+}
+
+TEST(AMLStringLanguage, HandleTest) {
+    const AMLStringLanguageId CS = 4;
+    std::vector<AMLStringHandle> row = {_("fox"), _("brown")};
+    EXPECT_EQ(sizeof(uint32_t), sizeof(AMLStringHandle));
+    EXPECT_EQ(_("fox").id(), row[0].id());
+    EXPECT_STREQ("fox", row[0].getOriginalString());
+    EXPECT_STREQ("fox", row[0].c_str());
+    EXPECT_EQ(3, row[0].size());
+    EXPECT_EQ(1, row[0].find('o'));
+    EXPECT_TRUE(row[1] == "brown");
+    EXPECT_GT(0, row[1].compare(row[0]));
+    AMLString fox = row[0];
+    EXPECT_EQ(_("fox").id(), fox.id());
+
+    AMLStringLanguage* cs = new AMLStringLanguage();
+    EXPECT_EQ(4, cs->load((g_data_dir + "/cs.mo").c_str()));
+    {
+        AMLStringLanguageScope scope(cs);
+        EXPECT_STREQ("liška", row[0].c_str());
+        EXPECT_EQ("hnědá", row[1].view());
+        EXPECT_STREQ("liška", fox.c_str());
+    }
+    AMLStringLanguage::publish(CS, cs);
+    EXPECT_EQ("liška", row[0].view(CS));
+    EXPECT_EQ("fox", row[0].view());
+
+    AMLStringReader reader;
+    AMLStringLanguage::publish(CS, nullptr);
+    AMLStringLanguage::retire(cs);
+    reader.quiescent();
+    EXPECT_EQ(1, AMLStringLanguage::reclaim());
+}
+
+TEST(AMLStringLanguage, BatchTest) {
+    AMLString texts[] = {_("welcome"), _("quick"), _("brown"), _("fox")};
+    const size_t count = sizeof(texts) / sizeof(texts[0]);
+    std::vector<AMLStringHandle> handles(texts, texts + count);
+    std::string_view views[count];
+
+    AMLString::resolve(texts, count, views);
+    EXPECT_EQ("fox", views[3]);
+    AMLStringHandle::resolve(handles.data(), count, views);
+    EXPECT_EQ("brown", views[2]);
+
+    AMLStringLanguage* cs = new AMLStringLanguage();
+    EXPECT_EQ(4, cs->load((g_data_dir + "/cs.mo").c_str()));
+    AMLStringOverlay acme(cs);
+    EXPECT_TRUE(acme.set(texts[0], "ACME"));
+    {
+        AMLStringOverlayScope scope(&acme);
+        AMLString::resolve(texts, count, views);
+        for (size_t i = 0; i < count; ++i)
+            EXPECT_EQ(texts[i].view(), views[i]);
+        EXPECT_EQ("ACME", views[0]);
+        EXPECT_EQ("liška", views[3]);
+        std::fill(views, views + count, std::string_view());
+        AMLStringHandle::resolve(handles.data(), count, views);
+        for (size_t i = 0; i < count; ++i)
+            EXPECT_EQ(texts[i].view(), views[i]);
+    }
+    AMLStringReader reader;
+    AMLStringLanguage::retire(cs);
+    reader.quiescent();
+    EXPECT_EQ(1, AMLStringLanguage::reclaim());
+}
+
+TEST(AMLStringLanguage, ArenaTest) {
+    AMLStringArena arena(true);
+    EXPECT_EQ(0, arena.capacity());
+    std::string plural("file\0files", 10);
+    const std::string_view first = arena.store(plural);
+    plural.clear();
+    EXPECT_EQ(std::string_view("file\0files", 10), first);
+    EXPECT_EQ('\0', first.data()[first.size()]);
+    EXPECT_EQ(first.data(), arena.store(std::string_view("file\0files", 10)).data());
+    EXPECT_NE(first.data(), arena.store("file").data());
+    EXPECT_EQ(16, arena.size());
+    EXPECT_EQ(AMLStringArena::HUGE_PAGE_SIZE, arena.capacity());
+    // index is rehashed within the block
+    std::vector<std::string_view> many;
+    for (int i = 0; i < 1000; ++i)
+        many.push_back(arena.store(std::to_string(i)));
+    for (int i = 0; i < 1000; ++i)
+        EXPECT_EQ(many[i].data(), arena.store(std::to_string(i)).data());
+    EXPECT_EQ(first.data(), arena.store(std::string_view("file\0files", 10)).data());
+    EXPECT_EQ(AMLStringArena::HUGE_PAGE_SIZE, arena.capacity());
+    arena.release();
+    EXPECT_EQ(0, arena.capacity());
+
+    AMLString fox = _("fox");
+    AMLString brown = _("brown");
+    AMLStringLanguage* cs = new AMLStringLanguage();
+    EXPECT_EQ(-1, cs->read((g_data_dir + "/nonexistent.mo").c_str()));
+    EXPECT_EQ(4, cs->read((g_data_dir + "/cs.mo").c_str()));
+    const size_t size = cs->arena().size();
+    EXPECT_LT(0, size);
+    cs->arena().store("hnědá");
+    EXPECT_EQ(size, cs->arena().size());
+
+    {
+        AMLStringLanguageScope scope(cs);
+        EXPECT_EQ("liška", fox.view());
+        EXPECT_EQ('\0', fox.c_str()[fox.size()]);
+        EXPECT_TRUE(cs->set(fox, "hnědá"));
+        EXPECT_EQ(brown.view().data(), fox.view().data());
+        EXPECT_EQ(size, cs->arena().size());
+    }
+
+    AMLStringReader reader;
+    AMLStringLanguage::retire(cs);
+    reader.quiescent();
+    EXPECT_EQ(1, AMLStringLanguage::reclaim());
+}
+
+TEST(AMLStringLanguage, CacheTest) {
+    const std::string cacheName = testing::TempDir() + "amlstring_bind.cache";
+    unlink(cacheName.c_str());
+    AMLString texts[] = {_("welcome"), _("quick"), _("brown"), _("fox")};
+
+    AMLStringLanguage* cs = new AMLStringLanguage();
+    EXPECT_EQ(-1, cs->loadCached((g_data_dir + "/nonexistent.mo").c_str(), cacheName.c_str()));
+    EXPECT_EQ(4, cs->loadCached((g_data_dir + "/cs.mo").c_str(), cacheName.c_str()));
+    EXPECT_EQ(0, access(cacheName.c_str(), R_OK));
+
+    // the second language is bound from cache
+    AMLStringLanguage* cached = new AMLStringLanguage();
+    EXPECT_EQ(4, cached->loadCached((g_data_dir + "/cs.mo").c_str(), cacheName.c_str()));
+    // cache of another catalog is not used
+    AMLStringLanguage* de = new AMLStringLanguage();
+    EXPECT_EQ(4, de->loadCached((g_data_dir + "/de.mo").c_str(), cacheName.c_str()));
+    auto viewIn = [](const AMLStringLanguage* language, const AMLString& text) {
+        AMLStringLanguageScope scope(language);
+        return text.view();
+    };
+    for (const AMLString& text : texts)
+        EXPECT_EQ(viewIn(cs, text), viewIn(cached, text));
+    EXPECT_EQ("liška", viewIn(cached, texts[3]));
+    EXPECT_EQ("Fuchs", viewIn(de, texts[3]));
+
+    // cache written for de.mo, entries cutting translations before their terminators reject it
+    FILE* file = fopen(cacheName.c_str(), "r+b");
+    ASSERT_NE(nullptr, file);
+    const long headerSize = 88;     // entries of 24 bytes follow, offset and length at 12 and 16
+    const long entrySize = 24;
+    fseek(file, 0, SEEK_END);
+    for (long position = ftell(file) - entrySize; position >= headerSize; position -= entrySize) {
+        uint32_t location[2];
+        fseek(file, position + 12, SEEK_SET);
+        ASSERT_EQ(2u, fread(location, sizeof(uint32_t), 2, file));
+        if (location[0] != ~uint32_t(0) && location[1] > 1) {
+            --location[1];
+            fseek(file, position + 16, SEEK_SET);
+            fwrite(&location[1], sizeof(uint32_t), 1, file);
+        }
+    }
+    fclose(file);
+    AMLStringLanguage* truncated = new AMLStringLanguage();
+    EXPECT_EQ(4, truncated->loadCached((g_data_dir + "/de.mo").c_str(), cacheName.c_str()));
+    for (const AMLString& text : texts)
+        EXPECT_EQ(viewIn(de, text), viewIn(truncated, text));
+
+    // garbage is ignored and overwritten
+    file = fopen(cacheName.c_str(), "w");
+    fputs("garbage", file);
+    fclose(file);
+    AMLStringLanguage* rebound = new AMLStringLanguage();
+    EXPECT_EQ(4, rebound->loadCached((g_data_dir + "/cs.mo").c_str(), cacheName.c_str()));
+    unlink(cacheName.c_str());
+
+    AMLStringReader reader;
+    AMLStringLanguage::retire(cs);
+    AMLStringLanguage::retire(cached);
+    AMLStringLanguage::retire(de);
+    AMLStringLanguage::retire(rebound);
+    AMLStringLanguage::retire(truncated);
+    reader.quiescent();
+    EXPECT_EQ(5, AMLStringLanguage::reclaim());
+}
+
+/*
+ *  Replaces catalog by rename, as package managers do
+ */
+static bool install(const char* source, const std::string& fileName)
+{
+    const std::string temporary = fileName + ".tmp";
+    std::ofstream(temporary, std::ios::binary) << std::ifstream(g_data_dir + "/" + source, std::ios::binary).rdbuf();
+    return rename(temporary.c_str(), fileName.c_str()) == 0;
+}
+
+TEST(AMLStringLanguage, WatcherTest) {
+    const AMLStringLanguageId WATCHED = 5;
+    const std::string fileName = testing::TempDir() + "amlstring_watched.mo";
+    AMLString brown = _("brown");
+    AMLString fox = _("fox");
+
+    ASSERT_TRUE(install("cs.mo", fileName));
+    AMLStringWatcher watcher;
+    EXPECT_EQ(-1, watcher.watch(WATCHED, (g_data_dir + "/nonexistent.mo").c_str()));
+    EXPECT_EQ(4, watcher.watch(WATCHED, fileName.c_str()));
+    EXPECT_EQ("liška", fox.view(WATCHED));
+    EXPECT_EQ(0, watcher.poll(0));
+
+    ASSERT_TRUE(install("cs_CZ.mo", fileName));
+    EXPECT_EQ(1, watcher.poll(1000));
+    EXPECT_EQ("lišák", fox.view(WATCHED));
+    EXPECT_EQ("brown", brown.view(WATCHED));
+
+    EXPECT_TRUE(watcher.start());
+    EXPECT_FALSE(watcher.start());
+    ASSERT_TRUE(install("cs.mo", fileName));
+    for (int i = 0; i < 200 && watcher.reloads() < 2; ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    watcher.stop();
+    EXPECT_EQ(2, watcher.reloads());
+    EXPECT_EQ("liška", fox.view(WATCHED));
+    EXPECT_EQ("hnědá", brown.view(WATCHED));
+    unlink(fileName.c_str());
+
+    AMLStringReader reader;
+    AMLStringLanguage::retire(const_cast<AMLStringLanguage*>(AMLStringLanguage::language(WATCHED)));
+    EXPECT_EQ(nullptr, AMLStringLanguage::language(WATCHED));
+    reader.quiescent();
+    AMLStringLanguage::reclaim();
+}
+
+TEST(AMLStringLanguage, WatcherPluralTest) {
+    const AMLStringLanguageId WATCHED = 5;
+    const std::string fileName = testing::TempDir() + "amlstring_watched_plural.mo";
+    // singular and plural string share msgid of one catalog entry
+    AMLString file = _D("watched", "%d file");
+    auto files = [](unsigned long n) {return _DN("watched", "%d file", "%d files", n);};
+
+    ASSERT_TRUE(install("cs.mo", fileName));
+    AMLStringWatcher watcher;
+    EXPECT_EQ(2, watcher.watch(WATCHED, fileName.c_str(), "watched"));
+    EXPECT_EQ("%d soubor", file.view(WATCHED));
+    EXPECT_EQ("%d soubory", files(3).view(WATCHED));
+
+    ASSERT_TRUE(install("de.mo", fileName));
+    EXPECT_EQ(1, watcher.poll(1000));
+    EXPECT_EQ("%d Datei", file.view(WATCHED));
+    EXPECT_EQ("%d Datei", files(1).view(WATCHED));
+    EXPECT_EQ("%d Dateien", files(3).view(WATCHED));
+
+    // entry removed, both strings fall back to originals
+    ASSERT_TRUE(install("cs_CZ.mo", fileName));
+    EXPECT_EQ(1, watcher.poll(1000));
+    EXPECT_EQ("%d file", file.view(WATCHED));
+    EXPECT_EQ("%d files", files(3).view(WATCHED));
+    unlink(fileName.c_str());
+
+    AMLStringReader reader;
+    AMLStringLanguage::retire(const_cast<AMLStringLanguage*>(AMLStringLanguage::language(WATCHED)));
+    // watcher only retires, nothing was deleted under readers
+    reader.quiescent();
+    EXPECT_EQ(3, AMLStringLanguage::reclaim());
+}
+
+TEST(AMLStringLanguage, WatcherDomainTest) {
+    const std::string fileName = testing::TempDir() + "amlstring_watched_domain.mo";
+    AMLString watchedFox = _D("watched domain", "fox");
+    AMLString fox = _("fox");
+
+    AMLStringLanguage* de = new AMLStringLanguage();
+    EXPECT_EQ(4, de->load((g_data_dir + "/de.mo").c_str()));
+    AMLStringLanguage::activate(de);
+
+    // catalog of domain is bound to its table, language active for all threads is kept
+    ASSERT_TRUE(install("cs.mo", fileName));
+    AMLStringWatcher watcher;
+    EXPECT_EQ(1, watcher.watch(fileName.c_str(), "watched domain"));
+    EXPECT_EQ(de, AMLStringLanguage::active());
+    EXPECT_EQ("liška", watchedFox.view());
+    EXPECT_EQ("Fuchs", fox.view());
+
+    ASSERT_TRUE(install("cs_CZ.mo", fileName));
+    EXPECT_EQ(1, watcher.poll(1000));
+    EXPECT_EQ("lišák", watchedFox.view());
+    EXPECT_EQ("Fuchs", fox.view());
+    unlink(fileName.c_str());
+    AMLStringLanguage::activate(nullptr);
+
+    AMLStringReader reader;
+    _T_AM_StringList::GetStringTable("watched domain")->Unload();
+    AMLStringLanguage::retire(de);
+    // both bindings were retired by table
+    reader.quiescent();
+    EXPECT_EQ(3, AMLStringLanguage::reclaim());
+}
+
+TEST(AMLStringLanguage, LoaderTest) {
+    const AMLStringLanguageId CS = 6;
+    const AMLStringLanguageId DE = 7;
+    AMLString fox = _("fox");
+    // nothing is published until language is bound
+    EXPECT_EQ("fox", fox.view(CS));
+
+    std::promise<int> deLoaded;
+    {
+        AMLStringLoader loader(2, 2);
+        std::future<int> cs = loader.load(CS, (g_data_dir + "/cs.mo").c_str());
+        std::future<int> missing = loader.load(CS, (g_data_dir + "/nonexistent.mo").c_str());
+        loader.load(DE, (g_data_dir + "/de.mo").c_str(), "default", [&deLoaded](int matched) {
+            deLoaded.set_value(matched);
+        });
+        EXPECT_EQ(4, cs.get());
+        EXPECT_EQ("liška", fox.view(CS));
+        EXPECT_EQ(-1, missing.get());
+    }
+    EXPECT_EQ(4, deLoaded.get_future().get());
+    EXPECT_EQ("Fuchs", fox.view(DE));
+    EXPECT_EQ("liška", fox.view(CS));
+
+    // language replaced by loader is retired
+    {
+        AMLStringLoader loader;
+        EXPECT_EQ(1, loader.load(DE, (g_data_dir + "/cs_CZ.mo").c_str()).get());
+    }
+    EXPECT_EQ("lišák", fox.view(DE));
+
+    // catalog of domain is bound to its table, active language is kept
+    AMLString loadedFox = _D("loaded domain", "fox");
+    AMLStringLanguage::activate(AMLStringLanguage::language(DE));
+    {
+        AMLStringLoader loader;
+        EXPECT_EQ(1, loader.load((g_data_dir + "/cs.mo").c_str(), "loaded domain").get());
+    }
+    EXPECT_EQ(AMLStringLanguage::language(DE), AMLStringLanguage::active());
+    EXPECT_EQ("liška", loadedFox.view());
+    EXPECT_EQ("lišák", fox.view());
+    AMLStringLanguage::activate(nullptr);
+
+    AMLStringReader reader;
+    _T_AM_StringList::GetStringTable("loaded domain")->Unload();
+    AMLStringLanguage::retire(const_cast<AMLStringLanguage*>(AMLStringLanguage::language(CS)));
+    AMLStringLanguage::retire(const_cast<AMLStringLanguage*>(AMLStringLanguage::language(DE)));
+    reader.quiescent();
+    EXPECT_EQ(4, AMLStringLanguage::reclaim());
+}
+
+TEST(AMLStringLanguage, StressTest) {
+    const std::string fileName = g_data_dir + "/cs.mo";
+    std::atomic<bool> stop(false);
+    std::atomic<size_t> torn(0);
+
+    auto readerThread = [&stop, &torn]() {
+        AMLStringReader reader;
+        while (!stop.load(std::memory_order_relaxed)) {
+            std::string_view fox = _("fox").view();
+            std::string_view brown = _("brown").view();
+            if (!(fox == "fox" || fox == "liška") || fox.data()[fox.size()] != '\0')
+                ++torn;
+            if (!(brown == "brown" || brown == "hnědá") || brown.data()[brown.size()] != '\0')
+                ++torn;
+            // separate reads of one string come from the language of the last quiescent state
+            AMLString text = _("fox");
+            const char* str = text.c_str();
+            // language switched by main thread between the reads
+            std::this_thread::yield();
+            if (strlen(str) != text.size() || std::string(text.begin(), text.end()) != str)
+                ++torn;
+            if (!(text == "fox" || text == "liška") || text[text.size() - 1] != str[strlen(str) - 1])
+                ++torn;
+            reader.quiescent();
+        }
+    };
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i)
+        readers.emplace_back(readerThread);
+
+    AMLStringLanguage* previous = nullptr;
+    for (int i = 0; i < 200; ++i) {
+        AMLStringLanguage* language = new AMLStringLanguage();
+        if (i % 2 == 0) {
+            EXPECT_EQ(4, language->load(fileName.c_str()));
+        }
+        AMLStringLanguage::activate(language);
+        if (previous)
+            AMLStringLanguage::retire(previous);
+        AMLStringLanguage::reclaim();
+        previous = language;
+    }
+    stop = true;
+    for (std::thread& t : readers)
+        t.join();
+    AMLStringLanguage::retire(previous);
+    AMLStringLanguage::reclaim();
+
+    EXPECT_EQ(0, torn.load());
+    EXPECT_EQ(nullptr, AMLStringLanguage::active());
+}
+
+TEST(AMLStringLanguage, LoadStressTest) {
+    const std::string names[] = {g_data_dir + "/cs.mo", g_data_dir + "/de.mo"};
+    std::atomic<bool> stop(false);
+    std::atomic<size_t> torn(0);
+
+    auto readerThread = [&stop, &torn]() {
+        AMLStringReader reader;
+        while (!stop.load(std::memory_order_relaxed)) {
+            std::string_view fox = _("fox").view();
+            if (!(fox == "fox" || fox == "liška" || fox == "Fuchs") || fox.data()[fox.size()] != '\0')
+                ++torn;
+            reader.quiescent();
+        }
+    };
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i)
+        readers.emplace_back(readerThread);
+
+    // table binding is switched under running readers, replaced catalogs are unmapped by reclaim()
+    _T_AM_StringList* list = _T_AM_StringList::GetStringTable("default");
+    for (int i = 0; i < 200; ++i) {
+        EXPECT_LT(0, list->Load(names[i % 2].c_str()));
+        AMLStringLanguage::reclaim();
+    }
+    stop = true;
+    for (std::thread& t : readers)
+        t.join();
+    list->Unload();
+    AMLStringLanguage::reclaim();
+
+    EXPECT_EQ(0, torn.load());
+    EXPECT_STREQ("fox", _("fox").c_str());
+}
+
+int main(int argc, char **argv) {
+
+     ::testing::InitGoogleTest(&argc, argv);
+     return RUN_ALL_TESTS();
+}
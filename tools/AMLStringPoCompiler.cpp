@@ -0,0 +1,468 @@
+/*!
+*   @file AMLStringPoCompiler.cpp
+*   Compiles <b>.po</b> file into C++ source with AMLStringCompiledCatalog.
+*
+*   Usage: AMLStringPoCompiler input.po output.cpp name
+*          AMLStringPoCompiler --fixed input.po output.h
+*
+*   All strings are emitted into one constant character array, entries refer to it by offsets and are
+*   sorted by FNV1a hash of original string, so generated tables need no relocation and no
+*   initialization except registration of the catalog. Minimal perfect hash of distinct hashes is
+*   generated with them (see AMLStringPerfectHash), every entry is then found in two probes.
+*
+*   With --fixed, header for AMLSTRING_FIXED_LANGUAGE mode is generated instead, "_" then finds
+*   translations in it at compile time.
+*
+*   @author Zdeněk Skulínek  &lt;<a href="mailto:zdenek.skulinek@seznam.cz">me@zdenekskulinek.cz</a>&gt;
+*/
+#include <algorithm>
+#include <cctype>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../AMLStringPerfectHash.h"
+#include "amfnv1a/AMCEFNV1a.h"
+
+// separates context from original string, same as in .mo files
+static const char CONTEXT_SEPARATOR = '\x04';
+
+struct PoEntry
+{
+    std::string context;
+    bool        hasContext = false;
+    std::string original;
+    std::string originalPlural;
+    bool        hasPlural = false;
+    std::vector<std::string> translations;
+    bool        fuzzy = false;
+    bool        obsolete = false;
+};
+
+struct CompiledEntry
+{
+    uint64_t    hash;
+    std::string original;       // context, separator, msgid and optional "\0" msgid_plural
+    std::string translation;    // forms separated by "\0"
+};
+
+/*
+ *  Parses quoted string with C escapes. Returns false on syntax error.
+ */
+static bool parseQuoted(const std::string& line, size_t pos, std::string& out)
+{
+    while (pos < line.size() && (line[pos] == ' ' || line[pos] == '\t'))
+        ++pos;
+    if (pos >= line.size() || line[pos] != '"')
+        return false;
+    for (++pos; pos < line.size(); ++pos) {
+        char c = line[pos];
+        if (c == '"') {
+            for (++pos; pos < line.size(); ++pos) {
+                if (line[pos] != ' ' && line[pos] != '\t' && line[pos] != '\r')
+                    return false;
+            }
+            return true;
+        }
+        if (c != '\\') {
+            out += c;
+            continue;
+        }
+        if (++pos >= line.size())
+            return false;
+        c = line[pos];
+        switch (c) {
+        case 'n': out += '\n'; break;
+        case 't': out += '\t'; break;
+        case 'r': out += '\r'; break;
+        case 'a': out += '\a'; break;
+        case 'b': out += '\b'; break;
+        case 'f': out += '\f'; break;
+        case 'v': out += '\v'; break;
+        case 'x': {
+            unsigned value = 0;
+            size_t digits = 0;
+            while (pos + 1 < line.size() && isxdigit(static_cast<unsigned char>(line[pos + 1]))) {
+                ++pos;
+                value = value * 16 + (isdigit(static_cast<unsigned char>(line[pos])) ? line[pos] - '0'
+                                                                                     : (tolower(line[pos]) - 'a' + 10));
+                ++digits;
+            }
+            if (!digits)
+                return false;
+            out += static_cast<char>(value);
+            break;
+        }
+        default:
+            if (c >= '0' && c <= '7') {
+                unsigned value = c - '0';
+                for (int i = 0; i < 2 && pos + 1 < line.size() && line[pos + 1] >= '0' && line[pos + 1] <= '7'; ++i)
+                    value = value * 8 + (line[++pos] - '0');
+                out += static_cast<char>(value);
+            }
+            else
+                out += c;   // \" \\ \' \?
+        }
+    }
+    return false;
+}
+
+static bool startsWith(const std::string& line, const char* prefix)
+{
+    return line.compare(0, strlen(prefix), prefix) == 0;
+}
+
+static bool parsePo(std::istream& in, const char* fileName, std::vector<PoEntry>& entries)
+{
+    enum Field {NONE, CONTEXT, ORIGINAL, PLURAL, TRANSLATION};
+    Field field = NONE;
+    PoEntry entry;
+    std::string line;
+    size_t lineNumber = 0;
+    bool started = false;
+    auto flush = [&]() {
+        if (started)
+            entries.push_back(entry);
+        entry = PoEntry();
+        started = false;
+        field = NONE;
+    };
+    auto error = [&](const char* message) {
+        std::cerr << fileName << ":" << lineNumber << ": " << message << std::endl;
+        return false;
+    };
+
+    while (std::getline(in, line)) {
+        ++lineNumber;
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        bool obsolete = false;
+        if (startsWith(line, "#~")) {
+            obsolete = true;
+            line.erase(0, 2);
+            while (!line.empty() && line[0] == ' ')
+                line.erase(0, 1);
+            if (line.empty())
+                continue;
+        }
+        else if (line.empty() || line[0] == '#') {
+            // comments belong to the following entry
+            if (field == TRANSLATION)
+                flush();
+            if (startsWith(line, "#,") && line.find("fuzzy") != std::string::npos)
+                entry.fuzzy = true;
+            continue;
+        }
+
+        std::string* target = nullptr;
+        size_t pos = 0;
+        if (startsWith(line, "msgctxt")) {
+            if (field != NONE)
+                flush();
+            entry.hasContext = true;
+            target = &entry.context;
+            pos = 7;
+            field = CONTEXT;
+        }
+        else if (startsWith(line, "msgid_plural")) {
+            if (field != ORIGINAL)
+                return error("msgid_plural without msgid");
+            entry.hasPlural = true;
+            target = &entry.originalPlural;
+            pos = 12;
+            field = PLURAL;
+        }
+        else if (startsWith(line, "msgid")) {
+            if (field == TRANSLATION || field == ORIGINAL || field == PLURAL)
+                flush();
+            target = &entry.original;
+            pos = 5;
+            field = ORIGINAL;
+        }
+        else if (startsWith(line, "msgstr[")) {
+            if (field != PLURAL && field != TRANSLATION)
+                return error("msgstr[] without msgid_plural");
+            const size_t close = line.find(']');
+            if (close == std::string::npos)
+                return error("invalid msgstr[]");
+            const size_t index = strtoul(line.c_str() + 7, nullptr, 10);
+            if (index != entry.translations.size())
+                return error("msgstr[] out of order");
+            entry.translations.emplace_back();
+            target = &entry.translations.back();
+            pos = close + 1;
+            field = TRANSLATION;
+        }
+        else if (startsWith(line, "msgstr")) {
+            if (field != ORIGINAL)
+                return error("msgstr without msgid");
+            entry.translations.emplace_back();
+            target = &entry.translations.back();
+            pos = 6;
+            field = TRANSLATION;
+        }
+        else if (line[0] == '"') {
+            switch (field) {
+            case CONTEXT:     target = &entry.context; break;
+            case ORIGINAL:    target = &entry.original; break;
+            case PLURAL:      target = &entry.originalPlural; break;
+            case TRANSLATION: target = &entry.translations.back(); break;
+            default:          return error("string without keyword");
+            }
+        }
+        else
+            return error("unknown keyword");
+        started = true;
+        entry.obsolete |= obsolete;
+        if (!parseQuoted(line, pos, *target))
+            return error("invalid string");
+    }
+    flush();
+    return true;
+}
+
+/*
+ *  Emits string as C literal. Octal escapes have always three digits, so following character can
+ *  never be taken as part of the escape.
+ */
+static void writeLiteral(std::ostream& out, const std::string& s, const char* terminator = "\\000")
+{
+    out << "\"";
+    for (unsigned char c : s) {
+        if (c == '"' || c == '\\')
+            out << '\\' << c;
+        else if (c < 0x20 || c == 0x7f || c == '?') {
+            char buffer[8];
+            snprintf(buffer, sizeof(buffer), "\\%03o", c);
+            out << buffer;
+        }
+        else
+            out << c;
+    }
+    out << terminator << "\"";
+}
+
+/*
+ *  Collects translated entries sorted by hash, header translation is returned separately.
+ */
+static void compileEntries(const std::vector<PoEntry>& entries, std::string& header,
+                           std::vector<CompiledEntry>& compiled)
+{
+    for (const PoEntry& entry : entries) {
+        if (entry.fuzzy || entry.obsolete)
+            continue;
+        if (!entry.hasContext && entry.original.empty()) {
+            if (!entry.translations.empty())
+                header = entry.translations[0];
+            continue;
+        }
+        // untranslated entries would only duplicate original strings
+        bool translated = !entry.translations.empty();
+        for (const std::string& translation : entry.translations)
+            translated &= !translation.empty();
+        if (!translated)
+            continue;
+
+        CompiledEntry result;
+        if (entry.hasContext)
+            result.original = entry.context + CONTEXT_SEPARATOR;
+        result.original += entry.original;
+        // plural part is appended after hashing, the string has no zero yet
+        result.hash = AMCore::AMCEFNV1aAlgorithm::fnv1a64(result.original.c_str());
+        if (entry.hasPlural) {
+            result.original += '\0';
+            result.original += entry.originalPlural;
+        }
+        for (size_t i = 0; i < entry.translations.size(); ++i) {
+            if (i)
+                result.translation += '\0';
+            result.translation += entry.translations[i];
+        }
+        compiled.push_back(result);
+    }
+    std::stable_sort(compiled.begin(), compiled.end(), [](const CompiledEntry& a, const CompiledEntry& b) {
+        return a.hash < b.hash;
+    });
+}
+
+struct PerfectHashTables
+{
+    uint32_t              count = 0;        // distinct hashes
+    std::vector<uint32_t> displacements;
+    std::vector<uint32_t> slots;            // first entry with hash of every slot
+};
+
+/*
+ *  Entries with the same hash (singular and plural of one msgid) share one key, find() then walks
+ *  them from the first one. Returns false if hashes of distinct keys collide or no displacement
+ *  places some bucket.
+ */
+static bool buildPerfectHash(const std::vector<CompiledEntry>& compiled, PerfectHashTables& tables)
+{
+    std::vector<uint64_t> hashes;
+    std::vector<uint32_t> first;
+    for (size_t i = 0; i < compiled.size(); ++i) {
+        if (i == 0 || compiled[i].hash != compiled[i - 1].hash) {
+            hashes.push_back(compiled[i].hash);
+            first.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    const uint32_t count = static_cast<uint32_t>(hashes.size());
+    tables.count = count;
+    if (!AMCore::AMLStringPerfectHash::build(hashes.data(), count, tables.displacements))
+        return false;
+    const AMCore::AMLStringPerfectHash perfectHash(tables.displacements.data(),
+                                                  static_cast<uint32_t>(tables.displacements.size()), count);
+    tables.slots.assign(count, 0);
+    for (uint32_t i = 0; i < count; ++i)
+        tables.slots[perfectHash(hashes[i])] = first[i];
+    // tables are never empty, so generated arrays are valid
+    if (tables.slots.empty())
+        tables.slots.push_back(0);
+    return true;
+}
+
+static void writeTable(std::ostream& out, const char* indent, const std::vector<uint32_t>& values)
+{
+    for (size_t i = 0; i < values.size(); ++i) {
+        out << (i % 16 == 0 ? indent : " ") << values[i] << ",";
+        if (i % 16 == 15 || i + 1 == values.size())
+            out << "\n";
+    }
+}
+
+static void writeSource(std::ostream& out, const char* poFile, const char* name, const std::string& header,
+                        const std::vector<CompiledEntry>& compiled, const PerfectHashTables& tables)
+{
+    out << "// Generated by AMLStringPoCompiler from " << poFile << ", do not edit.\n"
+        << "#include \"AMLStringCatalog.h\"\n\n"
+        << "namespace {\n\n"
+        << "constexpr char g_data[] =\n";
+    uint32_t offset = 0;
+    out << "    ";
+    writeLiteral(out, header);
+    out << "\n";
+    const uint32_t headerOffset = offset;
+    offset += header.size() + 1;
+    std::vector<uint32_t> offsets;
+    for (const CompiledEntry& entry : compiled) {
+        out << "    ";
+        writeLiteral(out, entry.original);
+        out << "\n    ";
+        offsets.push_back(offset);
+        offset += entry.original.size() + 1;
+        writeLiteral(out, entry.translation);
+        out << "\n";
+        offsets.push_back(offset);
+        offset += entry.translation.size() + 1;
+    }
+    out << "    ;\n\n"
+        << "constexpr AMCore::AMLStringCompiledEntry g_entries[] = {\n";
+    for (size_t i = 0; i < compiled.size(); ++i) {
+        char buffer[128];
+        snprintf(buffer, sizeof(buffer), "    {0x%016" PRIx64 "ULL, %u, %u, %u, %u},\n", compiled[i].hash,
+                 offsets[2 * i], static_cast<unsigned>(compiled[i].original.size()),
+                 offsets[2 * i + 1], static_cast<unsigned>(compiled[i].translation.size()));
+        out << buffer;
+    }
+    if (compiled.empty())
+        out << "    {0, 0, 0, 0, 0}\n";
+    out << "};\n\n"
+        << "constexpr uint32_t g_displacements[] = {\n";
+    writeTable(out, "    ", tables.displacements);
+    out << "};\n\n"
+        << "constexpr uint32_t g_slots[] = {\n";
+    writeTable(out, "    ", tables.slots);
+    out << "};\n\n"
+        << "AMCore::AMLStringCompiledCatalog g_catalog(\"" << name << "\", g_data + " << headerOffset
+        << ", g_data, g_entries, " << compiled.size() << ",\n"
+        << "    AMCore::AMLStringPerfectHash(g_displacements, " << tables.displacements.size() << ", "
+        << tables.count << "), g_slots);\n\n"
+        << "}//namespace\n";
+}
+
+/*
+ *  Header is included by AMLString.h, it only defines constant array. The last entry terminates
+ *  the array, so it is never empty.
+ */
+static void writeFixedHeader(std::ostream& out, const char* poFile, const std::string& header,
+                             const std::vector<CompiledEntry>& compiled, const PerfectHashTables& tables)
+{
+    out << "// Generated by AMLStringPoCompiler from " << poFile << ", do not edit.\n"
+        << "namespace AMCore {\n\n"
+        << "    inline constexpr const char* _T_AM_StringFixedHeader = ";
+    writeLiteral(out, header, "");
+    out << ";\n\n"
+        << "    inline constexpr _T_AM_StringFixedEntry _T_AM_StringFixedCatalog[] = {\n";
+    for (const CompiledEntry& entry : compiled) {
+        char buffer[64];
+        snprintf(buffer, sizeof(buffer), "        {0x%016" PRIx64 "ULL, ", entry.hash);
+        out << buffer;
+        writeLiteral(out, entry.original, "");
+        out << ", ";
+        writeLiteral(out, entry.translation, "");
+        out << ", " << entry.translation.size() << "},\n";
+    }
+    out << "        {0, nullptr, nullptr, 0}\n"
+        << "    };\n\n"
+        << "    inline constexpr size_t _T_AM_StringFixedCount = " << compiled.size() << ";\n\n"
+        << "    inline constexpr uint32_t _T_AM_StringFixedDisplacements[] = {\n";
+    writeTable(out, "        ", tables.displacements);
+    out << "    };\n\n"
+        << "    inline constexpr uint32_t _T_AM_StringFixedSlots[] = {\n";
+    writeTable(out, "        ", tables.slots);
+    out << "    };\n\n"
+        << "    inline constexpr AMLStringPerfectHash _T_AM_StringFixedPerfectHash(_T_AM_StringFixedDisplacements, "
+        << tables.displacements.size() << ", " << tables.count << ");\n\n"
+        << "}//namespace\n";
+}
+
+int main(int argc, char** argv)
+{
+    const bool fixed = argc == 4 && strcmp(argv[1], "--fixed") == 0;
+    if (argc != 4) {
+        std::cerr << "usage: " << argv[0] << " input.po output.cpp name\n"
+                  << "       " << argv[0] << " --fixed input.po output.h" << std::endl;
+        return 2;
+    }
+    const char* poFile = fixed ? argv[2] : argv[1];
+    const char* outFile = fixed ? argv[3] : argv[2];
+    std::ifstream in(poFile);
+    if (!in) {
+        std::cerr << poFile << ": cannot open" << std::endl;
+        return 1;
+    }
+    std::vector<PoEntry> entries;
+    if (!parsePo(in, poFile, entries))
+        return 1;
+
+    std::string header;
+    std::vector<CompiledEntry> compiled;
+    compileEntries(entries, header, compiled);
+
+    PerfectHashTables tables;
+    if (!buildPerfectHash(compiled, tables)) {
+        std::cerr << poFile << ": hashes of different strings collide or perfect hash cannot be built" << std::endl;
+        return 1;
+    }
+
+    std::ofstream out(outFile);
+    if (!out) {
+        std::cerr << outFile << ": cannot create" << std::endl;
+        return 1;
+    }
+    if (fixed)
+        writeFixedHeader(out, poFile, header, compiled, tables);
+    else
+        writeSource(out, poFile, argv[3], header, compiled, tables);
+    out.close();
+    if (!out) {
+        std::cerr << outFile << ": cannot write" << std::endl;
+        return 1;
+    }
+    return 0;
+}